@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+
+namespace core {
+
+// Canlı modda P tuşu olmadan otomatik notlandırma.
+//
+//  Armed   : Kağıt bekleniyor. Köşeler sabit + tüm bölgeler oturmuş -> Capture
+//  Holding : Sonuç gösteriliyor. Kağıt removalFrames kare boyunca görünmezse -> Armed
+//            (Kağıt kalkmadan farklı kimlikli bir kağıt oturursa doğrudan Capture)
+//
+// Sadece köşe aramanın gerçekten çalıştığı kareler kağıdın varlığı hakkında bilgi verir;
+// kalite kapısının attığı kareler (bulanık, hareketli) Unknown'dır ve sayılmaz.
+class AutoCapture {
+public:
+    enum class State { Armed, Holding };
+    enum class Event { None, Capture, Rearm };
+    enum class Presence {
+        Unknown,   // Bu karede köşe araması yapılmadı
+        Absent,    // Arama çalıştı, köşe yok
+        Present    // Köşeler bulundu
+    };
+
+    struct Params {
+        int removalFrames = 10;  // Yeniden kurulmak için art arda kağıtsız kare sayısı
+    };
+
+    AutoCapture() = default;
+    explicit AutoCapture(const Params& p) : params_(p) {}
+
+    // Her karede bir kez çağrılır.
+    // ready: köşeler sabit ve okuma oturdu; identityKey: makeIdentityKey() çıktısı (boş olabilir)
+    Event update(Presence presence, bool ready, const std::string& identityKey);
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled_; }
+
+    State state() const { return state_; }
+    int captureCount() const { return captures_; }
+    const char* stateText() const;
+
+private:
+    Event capture(const std::string& identityKey);
+
+    Params params_;
+    bool enabled_ = false;
+    State state_ = State::Armed;
+    int absentFrames_ = 0;
+    int captures_ = 0;
+    std::string capturedKey_;
+    // Son yakalanan kimlik; kağıdın gerçekten kalktığı görülene kadar tekrar yakalanmaz
+    // (açıp kapatma dahil)
+    std::string lastCapturedKey_;
+    bool absenceSeen_ = true;
+};
+
+}
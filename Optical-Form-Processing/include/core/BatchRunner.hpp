@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AnswerKey.hpp"
+#include "Dropout.hpp"
+#include "SheetIndex.hpp"
+#include "ThreadBudget.hpp"
+#include "WarpProfile.hpp"
+
+namespace core {
+
+struct BatchOptions {
+    int workers = 0;            // 0 -> ThreadBudget (çekirdekler - decode thread'leri)
+    SpeedPreset preset = SpeedPreset::Balanced;  // Warp boyutu şablondan türetilir
+    bool darknessScoring = false;                // Eşiklemesiz karanlık skoru (ROIDetector::SCORE_DARKNESS)
+    double fillThreshold = 0.40;
+    bool detectDuplicates = true;
+    bool scannerMode = false;   // Düz taramalar: benzerlik dönüşümü, perspektif ve iyileştirme yok
+    DropoutChannel dropout = DropoutChannel::None;   // Dropout mürekkebi: renkli aç, bu kanalı oku
+
+    // Önden okuma (ImagePrefetcher)
+    int readThreads = 2;        // io_uring yoksa paralel okuyucu sayısı
+    int decodeThreads = 0;      // 0 -> ThreadBudget (çekirdeklerin dörtte biri, en az 1)
+    size_t prefetchDepth = 8;   // Kuyruklardaki en fazla dosya / görüntü
+    bool useIoUring = true;
+
+    bool pinThreads = false;    // Worker / decode thread'leri çekirdeklere sabitlenir (Linux)
+};
+
+// G/Ç ile hesaplamayı ayrı raporlar (makine boyutlandırma için)
+struct BatchStats {
+    double wallMs = 0.0;
+    double ioWaitMs = 0.0;         // Dosya okuma beklemesi (okuyucu thread'leri)
+    double decodeMs = 0.0;         // Görüntü decode (decode thread'leri)
+    double computeMs = 0.0;        // Warp + okuma + puanlama (worker'lar)
+    double workerStarvedMs = 0.0;  // Worker'ların hazır görüntü beklediği süre
+    uint64_t bytesRead = 0;
+    bool usedIoUring = false;
+    int scanAligned = 0;           // Tarayıcı modunda hızlı yoldan geçen kağıt sayısı
+    ThreadPlan threads;            // Kullanılan thread bütçesi
+};
+
+struct BatchItem {
+    enum class Status {
+        Ok,
+        Rescan,       // Aynı kağıdın tekrar taraması; okuma atlandı, orijinal sonuç kopyalandı
+        DuplicateId,  // Aynı kimlik farklı kağıtta; okundu, incelemeye işaretlendi
+        NoPaper,      // Köşe işaretleri bulunamadı
+        ReadError     // Dosya okunamadı
+    };
+
+    std::string path;
+    Status status = Status::ReadError;
+    std::string duplicateOf;
+    SheetOutcome outcome;
+    double elapsedMs = 0.0;   // Worker'daki hesaplama süresi
+    double readMs = 0.0;
+    double decodeMs = 0.0;
+};
+
+class BatchRunner {
+public:
+    BatchRunner(const AnswerKey& key, const BatchOptions& opt);
+
+    // Dosyaları worker thread'lerle işler; sonuçlar giriş sırasıyla döner
+    std::vector<BatchItem> run(const std::vector<std::string>& paths);
+
+    const BatchStats& lastStats() const { return stats_; }
+    const WarpProfile& warpProfile() const { return profile_; }
+
+private:
+    AnswerKey key_;
+    BatchOptions opt_;
+    WarpProfile profile_;
+    BatchStats stats_;
+};
+
+// Argümanlardaki klasörleri görüntü dosyalarına açar (sıralı)
+std::vector<std::string> collectImagePaths(const std::vector<std::string>& inputs);
+
+// Tek satırlık JSON (JSON Lines çıktısı için)
+std::string toJsonLine(const BatchItem& item);
+
+const char* statusName(BatchItem::Status s);
+
+}
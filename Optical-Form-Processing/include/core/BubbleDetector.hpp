@@ -5,6 +5,8 @@
 #include <deque>
 #include <map>
 
+#include "BubbleMask.hpp"
+
 struct BubbleResult {
     int questionNumber;
     std::string markedAnswer; 
@@ -52,6 +54,56 @@ public:
         char firstLabel,
         cv::Mat* debugVis = nullptr);
 
+    // Ardışık warp karelerinde aynı bölgeyi füzyonla okur (temporal smoothing açıkken).
+    // Her şıkkın doluluk oranı üstel hareketli ortalama (EMA) ile birikir; satır kararları
+    // historySize_ kare boyunca değişmezse bölge "oturmuş" sayılır ve artık decode edilmez.
+    std::vector<BubbleResult> detectBubblesFused(
+        const cv::Mat& roiGray,
+        int rows,
+        int cols,
+        const std::string& regionKey,
+        int startQuestionNumber,
+        char firstLabel = 'A',
+        std::vector<std::vector<double>>* cellFillRatios = nullptr);
+
+    // Oranlar dışarıda ölçüldüyse (ör. karanlık skoru) aynı karar / füzyon yolu
+    std::vector<BubbleResult> detectFromRatios(
+        const std::vector<std::vector<double>>& ratios,
+        const std::string& regionKey,
+        int startQuestionNumber,
+        char firstLabel = 'A');
+
+    bool isRegionSettled(const std::string& regionKey) const;
+    const std::vector<BubbleResult>& settledResults(const std::string& regionKey) const;
+    // Oturmuş bölgenin kararı veren doluluk EMA'sı (rows x cols; yoksa boş)
+    const std::vector<std::vector<double>>& settledRatios(const std::string& regionKey) const;
+
+    void setTemporalSmoothing(bool enabled, int historySize = 5);
+    bool isTemporalSmoothingEnabled() const { return temporalSmoothingEnabled_; }
+    void resetTemporalState() { answerHistory_.clear(); }
+
+    // Satır kararında kullanılan güven eşiği (0-100, ROIDetector ile aynı olmalı)
+    void setDecisionConfidence(double c) { decisionConfidence_ = c; }
+
+    // Warp referans boyuttan (1600x2200) küçükse çekirdekler bu oranla küçülür
+    void setKernelScale(double scale) { kernelScale_ = scale; }
+
+    // Grid bölgelerinde bubble örnekleme ağırlıkları (maskeler yeniden kurulur)
+    void setMaskWeights(const core::MaskWeights& w);
+
+    // İki kademeli okuma: önce yarım çözünürlük, sadece karar eşiği bandındaki satırlar
+    // tam çözünürlükte tekrar ölçülür. band: eşiğin iki yanındaki pay (0..1).
+    // Varsayılan kapalı: bant dışındaki satırlar doğrulanmaz; açmadan önce omr_bench'in
+    // kaskad karşılaştırması gerçek taramalarda sıfır fark vermeli.
+    void setCascade(bool enabled, double band = 0.15) { cascadeEnabled_ = enabled; cascadeBand_ = band; }
+    bool isCascadeEnabled() const { return cascadeEnabled_; }
+
+    struct CascadeStats {
+        long rows = 0;      // Hızlı geçişte okunan satır
+        long refined = 0;   // Tam çözünürlükte tekrar ölçülen satır
+    };
+    const CascadeStats& cascadeStats() const { return cascadeStats_; }
+
     void drawBubbleDebug(
         cv::Mat& debugImg,
         const cv::Rect& roi,
@@ -73,22 +125,59 @@ private:
     bool temporalSmoothingEnabled_ = false;
     int historySize_ = 5;
     bool debugMode_ = false;
-    
+    double decisionConfidence_ = 60.0;
+    double kernelScale_ = 1.0;
+
+    // Kaskad: yarım çözünürlükte hücre bu kadar pikselden küçükse tek geçiş yapılır
+    static constexpr int kMinCascadeCellPx = 8;
+    bool cascadeEnabled_ = false;
+    double cascadeBand_ = 0.15;
+    CascadeStats cascadeStats_;
+
+    // Bölge başına temporal füzyon durumu
+    struct RegionHistory {
+        std::vector<std::vector<double>> ema;   // rows x cols doluluk EMA'sı
+        std::vector<char> lastDecision;         // satır başına son karar
+        std::vector<int> stableFrames;          // kararın kaç karedir aynı olduğu
+        std::vector<BubbleResult> fused;
+        bool settled = false;
+    };
+
     cv::Mat debugVis_;
-    std::map<int, std::deque<std::string>> answerHistory_;
+    std::map<std::string, RegionHistory> answerHistory_;
     std::vector<BubbleContour> lastDetectedBubbles_;
+
+    // Bölge boyutu / satır / sütun başına örnekleme maskeleri (deque: referanslar geçerli kalır)
+    core::MaskWeights maskWeights_;
+    std::deque<core::SamplingGrid> gridCache_;
+    const core::SamplingGrid& samplingGrid(cv::Size roi, int rows, int cols);
     // -------------------------------------------------------
 
     double calculateFillRatio(const cv::Mat& bubbleImg);
     
+    // history verilirse (smoothing) ölçülen oranlar EMA'ya katılır ve sonuçlar EMA'dan üretilir
     std::vector<BubbleResult> detectBubblesGridCore(
         const cv::Mat& roiGray,
         int rows,
         int cols,
         int startQuestionNumber,
         char firstLabel,
-        bool applySmoothing,
+        RegionHistory* history,
         std::vector<std::vector<double>>* cellFillRatios);
 
+    void binarizeForFill(const cv::Mat& gray, double scale, cv::Mat& thr) const;
+    bool isAmbiguousRow(const std::vector<double>& ratios) const;
+    void refineRow(const cv::Mat& roiGray, int rows, int cols, int r, std::vector<double>& rowRatios);
+
+    std::vector<BubbleResult> resultsFromRatios(
+        const std::vector<std::vector<double>>& ratios,
+        int startQuestionNumber,
+        char firstLabel,
+        RegionHistory* history);
+
+    // Bir satırın oran vektöründen sonuç üretir
+    BubbleResult rowResult(const std::vector<double>& ratios, int questionNumber, char firstLabel) const;
+    char rowDecision(const BubbleResult& r) const;
+
     cv::Rect refineBubbleRect(const cv::Mat& cellPatch, const cv::Rect& initialRect);
 };
\ No newline at end of file
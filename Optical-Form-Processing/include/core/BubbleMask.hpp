@@ -0,0 +1,78 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace core {
+
+// Bubble içi ağırlık profili. Yarıçaplar hücre boyutuna oranlıdır.
+// Basılı harf (merkez) ve bubble çerçevesi (kenar) boş bubble'da da mürekkep
+// içerdiğinden düşük ağırlık alır; asıl işaret halkası tam ağırlıktadır.
+struct MaskWeights {
+    double radius = 0.35;      // Dikey yarıçap / min(hücre genişliği, yüksekliği)
+    double aspect = 1.0;       // Yatay / dikey yarıçap (basılı bubble elipsse)
+    double centerFrac = 0.40;  // Bu orana kadar: basılı harf bölgesi
+    double outlineFrac = 0.80; // Bu orandan sonra: basılı çerçeve
+    uint8_t center = 96;
+    uint8_t ring = 255;
+    uint8_t outline = 64;
+};
+
+// Tek bubble için seyrek örnekleme maskesi: satır aralıkları (span) + bitişik uint8 ağırlıklar.
+// Skor, ikili (0/255) görüntüyle tamsayı nokta çarpımıdır; iç döngü bitişik
+// bayt dizileri üzerinde çalıştığı için derleyici tarafından vektörleştirilir.
+class BubbleMask {
+public:
+    BubbleMask() = default;
+
+    // cell: hücre boyutu (float, tamsayı bölme hatası birikmez)
+    static BubbleMask elliptical(const cv::Size2f& cell, const MaskWeights& w = MaskWeights());
+
+    // bin: CV_8U, 0/255. origin: maskenin sol üstü (tamamen görüntü içinde olmalı)
+    // Dönüş: ağırlıklı doluluk oranı (0..1)
+    double score(const cv::Mat& bin, cv::Point origin) const;
+
+    cv::Size size() const { return size_; }
+    int pixelCount() const { return static_cast<int>(weights_.size()); }
+
+    // Ağırlıkları görüntü olarak verir (debug)
+    cv::Mat render() const;
+
+private:
+    struct Span {
+        int16_t dy;
+        int16_t x0;
+        int16_t len;
+        int32_t wOffset;
+    };
+
+    std::vector<Span> spans_;
+    std::vector<uint8_t> weights_;
+    uint32_t weightSum_ = 0;
+    cv::Size size_;
+};
+
+// Bir grid bölgesinin (rows x cols) önceden hesaplanmış örnekleme düzeni.
+// Aynı bölge boyutu için bir kez kurulur ve her karede tekrar kullanılır.
+class SamplingGrid {
+public:
+    SamplingGrid(cv::Size roi, int rows, int cols, const MaskWeights& w = MaskWeights());
+
+    bool matches(cv::Size roi, int rows, int cols) const {
+        return roi == roi_ && rows == rows_ && cols == cols_;
+    }
+
+    // ratios: rows x cols ağırlıklı doluluk oranları
+    void score(const cv::Mat& bin, std::vector<std::vector<double>>& ratios) const;
+
+    const BubbleMask& mask() const { return mask_; }
+    cv::Point origin(int r, int c) const { return origins_[r * cols_ + c]; }
+
+private:
+    cv::Size roi_;
+    int rows_, cols_;
+    BubbleMask mask_;
+    std::vector<cv::Point> origins_;
+};
+
+}
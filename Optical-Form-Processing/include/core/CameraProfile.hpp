@@ -0,0 +1,38 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace core {
+
+// Kamera kalibrasyonu (iç parametreler + lens bozulması).
+// Ucuz geniş açılı kameralarda fıçı bozulması grid'i kağıt kenarlarında büker; profil
+// verilirse bozulma ayrı bir undistort geçişi yerine perspektif düzeltmesine katlanır
+// (bkz. buildFusedWarpMap): tam kare tek kez örneklenir.
+struct CameraProfile {
+    double fx = 0, fy = 0, cx = 0, cy = 0;
+    double k[8] = {0, 0, 0, 0, 0, 0, 0, 0};   // k1 k2 p1 p2 k3 k4 k5 k6 (OpenCV sırası)
+    cv::Size imageSize;                        // Kalibrasyon çözünürlüğü
+
+    bool empty() const { return fx <= 0.0 || fy <= 0.0; }
+
+    // frameSize çözünürlüğündeki karenin origin'den başlayan parçası için parametreler
+    // (çözünürlük farkında iç parametreler ölçeklenir, pencerede ana nokta kaydırılır)
+    CameraProfile adjusted(cv::Size frameSize, cv::Point origin) const;
+
+    // İdeal (bozulmasız) piksel -> kameranın gördüğü piksel
+    cv::Point2d distort(cv::Point2d ideal) const;
+    // Kameranın gördüğü piksel -> ideal piksel (yinelemeli ters çözüm)
+    cv::Point2d undistort(cv::Point2d observed) const;
+};
+
+// OpenCV kalibrasyon çıktısı (yml / xml): camera_matrix, distortion_coefficients,
+// image_width, image_height. Hata olursa false ve err doldurulur.
+bool loadCameraProfile(const std::string& path, CameraProfile& out, std::string& err);
+
+// Warp pikseli -> kare pikseli eşleme tablosu (CV_32FC2, warpSize).
+// idealH: warp -> ideal piksel homografisi (3x3 CV_64F). Homografi ve bozulma modeli sadece
+// step aralıklı düğümlerde hesaplanır, aradaki pikseller çift doğrusal ara değerlenir.
+void buildFusedWarpMap(const cv::Mat& idealH, const CameraProfile& cam,
+                       cv::Size warpSize, int step, cv::Mat& map);
+
+}
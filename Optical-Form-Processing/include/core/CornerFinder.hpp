@@ -2,6 +2,8 @@
 #include <opencv2/opencv.hpp>
 #include <array>
 #include <vector>
+#include "core/CameraProfile.hpp"
+#include "core/Dropout.hpp"
 
 namespace core {
 
@@ -10,24 +12,55 @@ struct CornerResult {
     cv::Mat warped_gray;
     cv::Mat debug_bgr;
     std::array<cv::Point2f,4> markers_orig{{{-1,-1},{-1,-1},{-1,-1},{-1,-1}}};
+    int quarterTurns = 0;   // Kağıdın görüntüdeki dönüklüğü (90° adım, köşe sırasına katlandı)
 };
 
 class CornerFinder {
 public:
     CornerFinder(int outW, int outH) : outW_(outW), outH_(outH) {}
     
-    CornerResult processFrame(const cv::Mat& bgr, bool debug_on) const;
+    // Giriş BGR veya tek kanallı gri olabilir.
+    // cam verilirse (bu görüntünün koordinatlarına uyarlanmış) lens bozulması warp'a katlanır
+    CornerResult processFrame(const cv::Mat& bgr, bool debug_on, const CameraProfile* cam = nullptr) const;
+
+    // Tarayıcı girişi (düz yatmış kağıt): işaretler küçük kopyada köşe pencerelerinde aranır,
+    // dönme + ölçek + kayma dört köşeden tek benzerlik dönüşümüyle bulunur ve warpAffine
+    // (mümkünse kopyasız kırpma) uygulanır. Uyum hatası veya açı büyükse paper_ok false döner.
+    CornerResult processScan(const cv::Mat& image) const;
+
+    // Yön tespiti için form yerleşim imzası (ROIDetector::layoutSignature).
+    // Boşsa yön tespiti yapılmaz, köşeler görüntüdeki konumlarına göre sıralanır.
+    void setLayoutSignature(const cv::Mat& signature);
+
+    // -1: otomatik, 0..3: sabit 90° adım (elle düzeltme)
+    void setOrientationOverride(int quarterTurns) { orientationOverride_ = quarterTurns; }
+    int orientationOverride() const { return orientationOverride_; }
+
+    // Renkli girişte gri yerine bu kanal kullanılır (köşe arama ve warp)
+    void setDropoutChannel(DropoutChannel c) { dropout_ = c; }
+    DropoutChannel dropoutChannel() const { return dropout_; }
 
 private:
     bool findCornerSquares(const cv::Mat& gray, 
                            std::vector<cv::Point2f>& corners, 
                            cv::Mat* dbg) const;
     
+    // processScan için: probe, gray'in scale oranında küçültülmüşü; köşeler gray koordinatında
+    bool findScanMarkers(const cv::Mat& gray, const cv::Mat& probe, double scale,
+                         std::vector<cv::Point2f>& corners) const;
+
+    // quarterTurns: sıralama bu kadar kaydırılır; kağıdın sol üstü ilk köşe olur
     std::vector<cv::Point2f> orderTLTRBRBL(const std::vector<cv::Point2f>& pts, 
-                                           cv::Point2f C) const;
+                                           cv::Point2f C, int quarterTurns = 0) const;
+
+    // Görüntü sırasındaki köşelerden kağıdın kaç çeyrek tur döndüğünü bulur
+    int detectQuarterTurns(const cv::Mat& gray, const std::vector<cv::Point2f>& imageOrder) const;
 
 private:
     int outW_, outH_;
+    cv::Mat layoutSig_;            // Sıfır ortalamalı, birim normlu CV_32F
+    int orientationOverride_ = -1;
+    DropoutChannel dropout_ = DropoutChannel::None;
 };
 
 }
\ No newline at end of file
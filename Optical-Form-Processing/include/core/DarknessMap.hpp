@@ -0,0 +1,59 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace core {
+
+// Eşiklemesiz bubble skoru.
+// Kağıt beyazı (aydınlatma) sayfa başına bir kez düşük çözünürlüklü bir arka plan
+// haritasından kestirilir; her bubble, gri warp'ın integral görüntüsü üzerinden
+// O(1) ile "normalize ortalama karanlık" olarak puanlanır:
+//
+//     karanlık = 1 - ortalama(gri) / kağıt_beyazı      skor = karanlık / fullDarkness
+//
+// Bölge başına blur / adaptif eşik / morfoloji yapılmaz; tüm alanlar tek eşikle karar verir.
+class DarknessMap {
+public:
+    struct Params {
+        int backgroundDiv = 16;      // Arka plan haritası ölçeği (warp / N)
+        double fullDarkness = 0.55;  // Kurşun kalemle tam dolu bubble'ın tipik karanlığı (skor = 1)
+        double bubbleRadius = 0.35;  // Bubble yarıçapı / min(hücre genişliği, yüksekliği)
+        double letterFrac = 0.40;    // Basılı harfin kapladığı merkez kare (bubble karesine oran)
+        double letterWeight = 0.38;  // Harf bölgesinin ağırlığı (maskedeki 96/255 ile aynı)
+    };
+
+    DarknessMap() = default;
+    explicit DarknessMap(const Params& p) : params_(p) {}
+
+    // Sayfa başına bir kez: integral görüntü + kağıt beyazı haritası
+    void build(const cv::Mat& gray);
+    bool empty() const { return integral_.empty(); }
+    void clear() { integral_.release(); white_.release(); }
+
+    // Dikdörtgen içi normalize karanlık (0..1, kağıt beyazına göre)
+    double meanDarkness(const cv::Rect& r) const;
+
+    // Hücre ortasındaki bubble'ın skoru (0..1); harf bölgesi düşük ağırlıklı
+    double bubbleScore(const cv::Rect2f& cell) const;
+
+    // roi: warp koordinatları; out: rows x cols skor
+    void scoreGrid(const cv::Rect& roi, int rows, int cols,
+                   std::vector<std::vector<double>>& out) const;
+
+    const Params& params() const { return params_; }
+
+    // Derleme zamanı yerleşim çekirdekleri için (bkz. FormLayout.hpp)
+    const cv::Mat& integralImage() const { return integral_; }
+    const cv::Mat& whiteMap() const { return white_; }
+
+private:
+    double rectSum(const cv::Rect& r) const;
+    double paperWhite(cv::Point2f p) const;
+
+    Params params_;
+    cv::Mat integral_;   // CV_32S, (H+1)x(W+1) (1600x2200x255 taşmaz)
+    cv::Mat white_;      // CV_32F, düşük çözünürlüklü kağıt beyazı
+    double whiteScale_ = 1.0;
+};
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Okuma sırasında üretilen kompakt iz (sadece debug modunda doldurulur).
+// Okuma döngüleri çizim yapmaz; görsel, bu veriden UI thread'inde ve pencere
+// çözünürlüğünde üretilir (bkz. renderDecodeTrace).
+struct RegionTrace {
+    std::string name;
+    cv::Rect roi;                  // Warp koordinatlarında okunan alan
+    int rows = 0;
+    int cols = 0;
+    bool columnPicks = false;      // true: sütun başına seçim (kimlik), false: satır başına (dersler)
+    std::vector<float> scores;     // rows * cols doluluk / karanlık (0..1); oturmuş gridde EMA,
+                                   // oturmuş kimlik alanında 0
+    std::vector<int16_t> picks;    // Seçilen hücre (satır veya sütun indeksi), -1: boş
+};
+
+struct DecodeTrace {
+    std::vector<RegionTrace> regions;
+    void clear() { regions.clear(); }
+};
+
+// warped: okunan form; display: hedef pencere boyutu (en-boy oranı korunur, büyütülmez).
+// cells=false: sadece bölge çerçeveleri ve seçimler; true: her hücre ve skoru da çizilir.
+cv::Mat renderDecodeTrace(const cv::Mat& warped, const DecodeTrace& trace,
+                          cv::Size display, bool cells);
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace core {
+
+// Düşen (dropout) mürekkep kanalı.
+// Kırmızı dropout mürekkebiyle basılmış formlarda grid, harfler ve bubble çerçeveleri kırmızı
+// kanalda kağıt beyazına karışır; kurşun kalem işaretleri ve siyah köşe işaretleri koyu kalır.
+// Bu kanalda okunan warp'ta grid'le uğraşan temizlik (kenar payları, açma, aşındırma) gerekmez.
+enum class DropoutChannel { None, Red, Green, Blue };
+
+bool parseDropoutChannel(const std::string& s, DropoutChannel& out);
+const char* dropoutChannelName(DropoutChannel c);
+
+// BGR düzenindeki kanal indeksi (None: -1)
+int dropoutChannelIndex(DropoutChannel c);
+
+// Renkli kareden kağıdın okunacağı tek kanal: None ise gri dönüşüm, değilse seçili kanal.
+// Tek kanallı giriş kopyalanmadan döner.
+void toSheetGray(const cv::Mat& image, DropoutChannel c, cv::Mat& out);
+
+}
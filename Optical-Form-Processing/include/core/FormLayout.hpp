@@ -0,0 +1,302 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "DarknessMap.hpp"
+#include "WarpProfile.hpp"
+
+namespace core {
+
+// Derleme zamanı form yerleşimi.
+// Çok basılan form tipleri için bölgeler constexpr tanımlanır; warp boyutu da sabitlendiğinde
+// her hücrenin integral görüntü adresleri derleme zamanında hesaplanır ve bölge başına
+// satır / sütun sayısı sabit, tamamen özelleşmiş skor döngüleri üretilir (FixedLayoutKernel).
+// Çalışma zamanı şablonları (JSON) aynı hesabı DarknessMap::scoreGrid ile yapar.
+
+// Alan türü: okuma kuralı ve ROI kırpması buna göre seçilir
+enum class FieldKind {
+    Answers,   // Ders cevap gridi (soldaki soru numaraları atlanır)
+    Digits,    // tc_kimlik / ogrenci_no: sütun başına rakam
+    Letters,   // adi_soyadi: sütun başına harf
+    Column     // Tek sütun alan
+};
+
+struct RegionDesc {
+    const char* name;
+    float rect[4];    // {x, y, w, h} form oranı
+    int rows;
+    int cols;
+    FieldKind kind;
+    bool grid;        // false: COLUMN bölgesi (kenar kırpması yok)
+};
+
+template <std::size_t N>
+struct LayoutDesc {
+    std::array<RegionDesc, N> regions;
+};
+
+// constexpr dikdörtgen (cv::Rect derleme zamanında kullanılamıyor)
+struct PixRect {
+    int x = 0, y = 0, width = 0, height = 0;
+
+    constexpr int area() const { return width * height; }
+    cv::Rect rect() const { return cv::Rect(x, y, width, height); }
+};
+
+namespace layout {
+
+constexpr int floorInt(double v) {
+    const int i = static_cast<int>(v);
+    return (v < i) ? i - 1 : i;
+}
+
+// cvRound ile aynı: yarımda çifte yuvarlar
+constexpr int roundEven(double v) {
+    const int i = floorInt(v);
+    const double f = v - i;
+    if (f > 0.5) return i + 1;
+    if (f < 0.5) return i;
+    return (i % 2 == 0) ? i : i + 1;
+}
+
+// cv::Rect & cv::Rect
+constexpr PixRect intersect(const PixRect& a, const PixRect& b) {
+    const int x1 = std::max(a.x, b.x);
+    const int y1 = std::max(a.y, b.y);
+    const int w = std::min(a.x + a.width, b.x + b.width) - x1;
+    const int h = std::min(a.y + a.height, b.y + b.height) - y1;
+    if (w <= 0 || h <= 0) return PixRect{};
+    return PixRect{x1, y1, w, h};
+}
+
+} // namespace layout
+
+// Bölgenin warp içindeki okuma dikdörtgeni (ROIDetector ve derleme zamanı çekirdekleri ortak kullanır)
+constexpr PixRect regionRoi(const float rect[4], bool grid, bool answers, int warpW, int warpH) {
+    PixRect r{static_cast<int>(rect[0] * warpW), static_cast<int>(rect[1] * warpH),
+              static_cast<int>(rect[2] * warpW), static_cast<int>(rect[3] * warpH)};
+
+    // GRID bölgelerinde border gürültüsünü azalt
+    if (grid) {
+        const int dx = std::max(1, static_cast<int>(r.width * 0.02));
+        const int dy = std::max(1, static_cast<int>(r.height * 0.02));
+        r = PixRect{r.x + dx, r.y + dy, std::max(1, r.width - 2 * dx), std::max(1, r.height - 2 * dy)};
+    }
+
+    // Ders alanları: koordinatlar soru numarasının başladığı yerdir; soldan %19 (numaralar)
+    // atlanır, sağdan taşmamak için genişlik %95 ile sınırlanır
+    if (answers) {
+        const int originalW = r.width;
+        const int offsetX = static_cast<int>(originalW * 0.19);
+        const int targetTotalW = static_cast<int>(originalW * 0.95);
+        r.x += offsetX;
+        r.width = std::max(1, targetTotalW - offsetX);
+    }
+
+    return layout::intersect(r, PixRect{0, 0, warpW, warpH});
+}
+
+// ROIDetector::minCellPitch ile aynı hesap
+template <std::size_t N>
+constexpr std::pair<float, float> layoutMinPitch(const LayoutDesc<N>& L) {
+    float w = 1.f, h = 1.f;
+    for (const auto& reg : L.regions) {
+        w = std::min(w, reg.rect[2] / std::max(1, reg.cols));
+        h = std::min(h, reg.rect[3] / std::max(1, reg.rows));
+    }
+    return {w, h};
+}
+
+template <std::size_t N>
+constexpr WarpDims layoutWarpDims(const LayoutDesc<N>& L, SpeedPreset preset) {
+    const auto pitch = layoutMinPitch(L);
+    return warpDimsFor(pitch.first, pitch.second, preset);
+}
+
+// Özelleşmiş skor çekirdeğinin tür silinmiş arayüzü
+class FixedGridScorer {
+public:
+    virtual ~FixedGridScorer() = default;
+
+    virtual cv::Size warpSize() const = 0;
+
+    // index: yerleşimdeki bölge sırası. Harita bu warp boyutunda / varsayılan parametrelerle
+    // kurulmadıysa false (çağıran DarknessMap::scoreGrid'e döner). Sonuç scoreGrid ile aynıdır.
+    virtual bool scoreRegion(std::size_t index, const DarknessMap& map,
+                             std::vector<std::vector<double>>& out) const = 0;
+};
+
+namespace layout {
+
+// Bir hücrenin integral görüntü ve kağıt beyazı haritasındaki adresleri
+// (DarknessMap::bubbleScore'un derleme zamanı karşılığı)
+struct CellTaps {
+    int outer[4] = {0, 0, 0, 0};    // (y, x) (y, x+w) (y+h, x) (y+h, x+w)
+    int letter[4] = {0, 0, 0, 0};
+    double letterK = 0.0;           // Harf bölgesi yoksa 0
+    double area = 0.0;
+    int white = 0;
+    bool valid = false;
+};
+
+constexpr int whiteCols(int W, const DarknessMap::Params& p) {
+    return roundEven(W * (1.0 / std::max(1, p.backgroundDiv)));
+}
+
+constexpr CellTaps makeCellTaps(const PixRect& roi, int rows, int cols, int r, int c,
+                                int W, int H, const DarknessMap::Params& p) {
+    CellTaps t;
+
+    // DarknessMap::scoreGrid hücresi
+    const float cw = static_cast<float>(roi.width) / cols;
+    const float ch = static_cast<float>(roi.height) / rows;
+    const float x = roi.x + c * cw;
+    const float y = roi.y + r * ch;
+
+    // DarknessMap::bubbleScore
+    const float cx = x + cw * 0.5f;
+    const float cy = y + ch * 0.5f;
+    const float rad = static_cast<float>(p.bubbleRadius * std::min(cw, ch));
+    const float half = rad * 0.7071f;
+    const float letterHalf = half * static_cast<float>(p.letterFrac);
+
+    const PixRect bounds{0, 0, W, H};
+    auto squareAt = [&](float h) {
+        const int x0 = roundEven(cx - h), y0 = roundEven(cy - h);
+        const int x1 = roundEven(cx + h), y1 = roundEven(cy + h);
+        return intersect(PixRect{std::min(x0, x1), std::min(y0, y1),
+                                 std::max(x0, x1) - std::min(x0, x1),
+                                 std::max(y0, y1) - std::min(y0, y1)}, bounds);
+    };
+    const PixRect outer = squareAt(half);
+    const PixRect letter = squareAt(letterHalf);
+    if (outer.area() <= 0) return t;
+
+    const int stride = W + 1;
+    auto taps = [&](const PixRect& q, int* out) {
+        out[0] = q.y * stride + q.x;
+        out[1] = q.y * stride + q.x + q.width;
+        out[2] = (q.y + q.height) * stride + q.x;
+        out[3] = (q.y + q.height) * stride + q.x + q.width;
+    };
+    taps(outer, t.outer);
+
+    const double k = 1.0 - p.letterWeight;
+    if (letter.area() > 0) {
+        taps(letter, t.letter);
+        t.letterK = k;
+    }
+    t.area = outer.area() - (letter.area() > 0 ? k * letter.area() : 0.0);
+    if (t.area <= 0.0) return t;
+
+    const double scale = 1.0 / std::max(1, p.backgroundDiv);
+    const int wCols = whiteCols(W, p);
+    const int wRows = roundEven(H * scale);
+    const int wx = std::clamp(static_cast<int>(cx * scale), 0, wCols - 1);
+    const int wy = std::clamp(static_cast<int>(cy * scale), 0, wRows - 1);
+    t.white = wy * wCols + wx;
+    t.valid = true;
+    return t;
+}
+
+template <std::size_t N>
+constexpr std::array<std::size_t, N + 1> cellOffsets(const LayoutDesc<N>& L) {
+    std::array<std::size_t, N + 1> off{};
+    for (std::size_t i = 0; i < N; ++i)
+        off[i + 1] = off[i] + static_cast<std::size_t>(L.regions[i].rows * L.regions[i].cols);
+    return off;
+}
+
+template <const auto& L, int W, int H>
+constexpr auto buildTaps() {
+    constexpr std::size_t N = L.regions.size();
+    constexpr auto off = cellOffsets(L);
+    constexpr DarknessMap::Params p{};
+
+    std::array<CellTaps, off[N]> taps{};
+    for (std::size_t i = 0; i < N; ++i) {
+        const RegionDesc& reg = L.regions[i];
+        const PixRect roi = regionRoi(reg.rect, reg.grid, reg.kind == FieldKind::Answers, W, H);
+        for (int r = 0; r < reg.rows; ++r)
+            for (int c = 0; c < reg.cols; ++c)
+                taps[off[i] + static_cast<std::size_t>(r * reg.cols + c)] =
+                    makeCellTaps(roi, reg.rows, reg.cols, r, c, W, H, p);
+    }
+    return taps;
+}
+
+} // namespace layout
+
+// L yerleşimi, W x H warp ve varsayılan DarknessMap parametreleri için özelleşmiş skor çekirdeği.
+// Hücre adresleri derleme zamanı tablosundan okunur; bölge döngülerinin sınırları sabittir.
+template <const auto& L, int W, int H>
+class FixedLayoutKernel final : public FixedGridScorer {
+public:
+    static constexpr std::size_t kRegions = L.regions.size();
+
+    cv::Size warpSize() const override { return cv::Size(W, H); }
+
+    bool scoreRegion(std::size_t index, const DarknessMap& map,
+                     std::vector<std::vector<double>>& out) const override {
+        if (index >= kRegions || map.empty() || !matches(map)) return false;
+        dispatch(index, map.integralImage().ptr<int>(), map.whiteMap().ptr<float>(), out,
+                 std::make_index_sequence<kRegions>{});
+        return true;
+    }
+
+private:
+    using ScoreFn = void (*)(const int*, const float*, std::vector<std::vector<double>>&);
+
+    static constexpr DarknessMap::Params kParams{};
+    static constexpr auto kOffsets = layout::cellOffsets(L);
+    static constexpr auto kTaps = layout::buildTaps<L, W, H>();
+    static constexpr int kWhiteCols = layout::whiteCols(W, kParams);
+    static constexpr int kWhiteRows = layout::roundEven(H * (1.0 / std::max(1, kParams.backgroundDiv)));
+
+    static bool matches(const DarknessMap& map) {
+        const cv::Mat& I = map.integralImage();
+        const cv::Mat& Wm = map.whiteMap();
+        const DarknessMap::Params& p = map.params();
+        return I.cols == W + 1 && I.rows == H + 1 && I.isContinuous() &&
+               Wm.cols == kWhiteCols && Wm.rows == kWhiteRows && Wm.isContinuous() &&
+               p.backgroundDiv == kParams.backgroundDiv && p.fullDarkness == kParams.fullDarkness &&
+               p.bubbleRadius == kParams.bubbleRadius && p.letterFrac == kParams.letterFrac &&
+               p.letterWeight == kParams.letterWeight;
+    }
+
+    static double cellScore(const layout::CellTaps& t, const int* I, const float* white) {
+        if (!t.valid) return 0.0;
+        const double outer = static_cast<double>(I[t.outer[3]] - I[t.outer[2]] - I[t.outer[1]] + I[t.outer[0]]);
+        const double letter = static_cast<double>(I[t.letter[3]] - I[t.letter[2]] - I[t.letter[1]] + I[t.letter[0]]);
+        const double sum = outer - t.letterK * letter;
+        const double darkness = 1.0 - (sum / t.area) / std::max(1.0f, white[t.white]);
+        return std::clamp(darkness / kParams.fullDarkness, 0.0, 1.0);
+    }
+
+    template <std::size_t I>
+    static void scoreOne(const int* integ, const float* white, std::vector<std::vector<double>>& out) {
+        constexpr int Rows = L.regions[I].rows;
+        constexpr int Cols = L.regions[I].cols;
+        constexpr const layout::CellTaps* taps = kTaps.data() + kOffsets[I];
+
+        out.resize(Rows);
+        for (int r = 0; r < Rows; ++r) {
+            out[r].resize(Cols);
+            double* dst = out[r].data();
+            for (int c = 0; c < Cols; ++c) dst[c] = cellScore(taps[r * Cols + c], integ, white);
+        }
+    }
+
+    template <std::size_t... I>
+    static void dispatch(std::size_t index, const int* integ, const float* white,
+                         std::vector<std::vector<double>>& out, std::index_sequence<I...>) {
+        static constexpr ScoreFn table[] = {&FixedLayoutKernel::scoreOne<I>...};
+        table[index](integ, white, out);
+    }
+};
+
+}
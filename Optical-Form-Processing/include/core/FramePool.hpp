@@ -0,0 +1,62 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace core {
+
+// Canlı döngü için yeniden kullanılan kare tamponları.
+// Sahiplik havuzun kendisinde tutulur: acquire() bir tamponu kiralar (Lease), kira
+// bırakılana kadar tampon başka yakalamaya verilmez. Yakalama (VideoCapture::read) kiralık
+// tamponu aynı boyuttaysa yeniden ayırmadan doldurur; döngünün geri kalanı kopya yerine
+// bu tamponun görünümlerini kullanır. Görünümler kira bırakılınca geçersiz sayılmalıdır.
+class FramePool {
+public:
+    // Taşınabilir kira tutamacı; yıkıcı tamponu havuza geri verir. Havuzdan uzun yaşamamalı.
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease() { release(); }
+
+        Lease(Lease&& o) noexcept;
+        Lease& operator=(Lease&& o) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        // Kiralanan tampon (okuyucu buna yazar)
+        cv::Mat& mat();
+
+        bool held() const { return pool_ != nullptr; }
+        void release();
+
+    private:
+        friend class FramePool;
+        Lease(FramePool* pool, int slot) : pool_(pool), slot_(slot) {}
+
+        FramePool* pool_ = nullptr;
+        int slot_ = -1;       // -1: havuz doluyken verilen havuz dışı tampon
+        cv::Mat detached_;
+    };
+
+    explicit FramePool(size_t capacity = 4) : capacity_(capacity) { slots_.reserve(capacity_); }
+
+    // Boştaki bir tamponu kiralar; hepsi kiradaysa ve havuz doluysa havuz dışı tampon verir
+    Lease acquire();
+
+    size_t size() const { return slots_.size(); }
+    long allocations() const { return allocations_; }
+
+private:
+    struct Slot {
+        cv::Mat buf;
+        const uchar* data = nullptr;   // Kiralanırken tamponun adresi (yeniden ayırma tespiti)
+        bool leased = false;
+    };
+
+    void giveBack(int slot, const cv::Mat& detached);
+
+    size_t capacity_;
+    std::vector<Slot> slots_;   // capacity_ kadar ayrılır: kiralar indeks tutar, adres değişmez
+    long allocations_ = 0;
+};
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <array>
+
+namespace core {
+
+struct QualityVerdict {
+    enum class Reason {
+        Ok,
+        Blurry,           // Laplacian varyansı düşük (odak / hareket bulanıklığı)
+        Moving,           // Önceki kareye göre fark yüksek (kağıt hareket ediyor)
+        CornersUnstable   // Köşe işaretleri kareler arasında kayıyor
+    };
+
+    bool decode = true;
+    Reason reason = Reason::Ok;
+    double sharpness = 0.0;    // Laplacian varyansı (küçük karede)
+    double motion = 0.0;       // Ortalama mutlak fark (gri seviye)
+    double cornerShift = 0.0;  // Köşelerin en büyük kayması (tam kare pikseli)
+
+    const char* text() const;
+};
+
+// Canlı döngüde warp + ROI okumasından önce çalışan ucuz kalite kapısı.
+// Tüm ölçümler ~320 piksel genişliğe küçültülmüş kare üzerinde yapılır.
+class FrameQualityGate {
+public:
+    struct Params {
+        int probeWidth = 320;
+        double minSharpness = 30.0;
+        double maxMotion = 8.0;
+        double maxCornerShiftPx = 6.0;
+    };
+
+    FrameQualityGate() = default;
+    explicit FrameQualityGate(const Params& p) : params_(p) {}
+
+    // 1. aşama: keskinlik + hareket (warp'tan önce)
+    // frame: her karede aynı alan (tam kare); hareket önceki örnekle karşılaştırılır
+    QualityVerdict checkFrame(const cv::Mat& frame);
+
+    // 2. aşama: köşe kararlılığı (köşeler bulunduktan sonra, okumadan önce)
+    QualityVerdict checkCorners(const std::array<cv::Point2f, 4>& corners);
+
+    // Kağıt kaybolduğunda çağrılır
+    void resetCorners() { hasCorners_ = false; }
+
+    const QualityVerdict& last() const { return last_; }
+    Params& params() { return params_; }
+
+private:
+    Params params_;
+    cv::Mat prevSmall_;
+    std::array<cv::Point2f, 4> prevCorners_{};
+    bool hasCorners_ = false;
+    QualityVerdict last_;
+};
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Kayıttan oynatmada kare hızı
+enum class Pacing {
+    AsFastAsPossible,  // Kareler beklemeden verilir (benchmark)
+    RealTime           // Kayıttaki zaman damgalarına göre beklenir (saha koşulları)
+};
+
+// Ham kamera piksel formatı (V4L2 / ham kayıt); okumada sadece parlaklık (Y) düzlemi kullanılır
+enum class LumaFormat {
+    Grey,  // 8 bit gri
+    Yuyv,  // YUV 4:2:2 paketli (Y0 U Y1 V)
+    Nv12   // YUV 4:2:0, önce tam Y düzlemi
+};
+
+// Canlı döngünün kare kaynağı: kamera, video dosyası veya görüntü dizisi
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // Sıradaki kare; kaynak bittiğinde veya hata olduğunda false
+    virtual bool read(cv::Mat& frame) = 0;
+
+    // Son karenin kaynak zamanı (ms, ilk kare ~0)
+    virtual double timestampMs() const = 0;
+
+    virtual bool isLive() const = 0;
+    virtual std::string describe() const = 0;
+};
+
+// Gerçek zamanlı oynatma için bekleme yardımcısı.
+// Döngü kayıttan çok geri kalırsa (ör. duraklatma sonrası) zaman çizelgesi yeniden başlatılır.
+class ReplayPacer {
+public:
+    explicit ReplayPacer(Pacing p) : pacing_(p) {}
+    void wait(double frameTsMs);
+
+private:
+    Pacing pacing_;
+    bool started_ = false;
+    double ts0_ = 0.0;
+    std::chrono::steady_clock::time_point wall0_;
+};
+
+class CameraSource : public FrameSource {
+public:
+    CameraSource(int index, cv::Size size = {1920, 1080}, double fps = 30.0);
+
+    bool isOpened() const { return cap_.isOpened(); }
+    bool read(cv::Mat& frame) override;
+    double timestampMs() const override { return tsMs_; }
+    bool isLive() const override { return true; }
+    std::string describe() const override;
+
+private:
+    cv::VideoCapture cap_;
+    int index_;
+    double tsMs_ = 0.0;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+class VideoFileSource : public FrameSource {
+public:
+    VideoFileSource(const std::string& path, Pacing pacing);
+
+    bool isOpened() const { return cap_.isOpened(); }
+    bool read(cv::Mat& frame) override;
+    double timestampMs() const override { return tsMs_; }
+    bool isLive() const override { return false; }
+    std::string describe() const override;
+
+private:
+    cv::VideoCapture cap_;
+    std::string path_;
+    ReplayPacer pacer_;
+    double fps_ = 30.0;
+    long frameIndex_ = 0;
+    double tsMs_ = 0.0;
+};
+
+class ImageSequenceSource : public FrameSource {
+public:
+    // spec: klasör veya glob deseni (ör. "kayit/*.jpg")
+    ImageSequenceSource(const std::string& spec, double fps, Pacing pacing);
+
+    bool isOpened() const { return !paths_.empty(); }
+    bool read(cv::Mat& frame) override;
+    double timestampMs() const override { return tsMs_; }
+    bool isLive() const override { return false; }
+    std::string describe() const override;
+
+private:
+    std::vector<std::string> paths_;
+    std::string spec_;
+    ReplayPacer pacer_;
+    double fps_;
+    size_t index_ = 0;
+    double tsMs_ = 0.0;
+};
+
+struct FrameSourceSpec {
+    enum class Kind { Camera, Video, Images, V4l2, RawLuma } kind = Kind::Camera;
+    int cameraIndex = 0;
+    std::string path;
+    Pacing pacing = Pacing::RealTime;
+    double sequenceFps = 30.0;
+
+    // V4L2 kamerası (path = aygıt) ve ham kayıt dosyası
+    LumaFormat lumaFormat = LumaFormat::Yuyv;
+    cv::Size frameSize{1920, 1080};
+    int bufferCount = 4;
+};
+
+// Kaynağı açar; açılamazsa nullptr ve err doldurulur
+std::unique_ptr<FrameSource> openFrameSource(const FrameSourceSpec& spec, std::string& err);
+
+}
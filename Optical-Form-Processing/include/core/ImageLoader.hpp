@@ -0,0 +1,30 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "core/Dropout.hpp"
+
+namespace core {
+
+// Tarayıcı görüntülerini doğrudan gri ve küçültülmüş olarak açar.
+// JPEG'lerde libjpeg'in DCT-domain ölçeklemesi (1/2, 1/4, 1/8) kullanılır;
+// tam çözünürlüklü renkli görüntü hiç oluşturulmaz.
+
+// Dosyayı belleğe okur
+bool readFileBytes(const std::string& path, std::vector<uchar>& bytes);
+
+// JPEG başlığından (SOF) boyutu okur, decode etmez
+bool readJpegSize(const std::vector<uchar>& bytes, cv::Size& size);
+
+// Kağıdın warp çıktısını (needed) karşılayan en büyük küçültme faktörü: 1, 2, 4 veya 8
+int chooseReduction(cv::Size source, cv::Size needed);
+
+// Bellekteki görüntüyü warp için yeterli en düşük çözünürlükte gri olarak açar.
+// dropout verilirse renkli (küçültülmüş) açılır ve sadece o kanal döner
+cv::Mat decodeGrayForWarp(const std::vector<uchar>& bytes, cv::Size needed,
+                          DropoutChannel dropout = DropoutChannel::None);
+
+cv::Mat loadGrayForWarp(const std::string& path, cv::Size needed,
+                        DropoutChannel dropout = DropoutChannel::None);
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.hpp"
+#include "Dropout.hpp"
+
+namespace core {
+
+// Batch için önden okuyucu:
+//   okuma thread'i (io_uring veya bloklayan read) -> bayt kuyruğu
+//   -> decode thread'leri (ImageLoader) -> hazır gri Mat kuyruğu -> grading worker'ları
+// Her iki kuyruk da sınırlıdır; yavaş tüketici okumayı durdurur, bellek sınırlı kalır.
+class ImagePrefetcher {
+public:
+    struct Options {
+        cv::Size needed{1600, 2200};  // Warp çıktısı (küçültme faktörü seçimi için)
+        int readThreads = 2;          // io_uring yoksa paralel bloklayan okuyucu sayısı
+        int decodeThreads = 2;
+        int ioDepth = 8;              // io_uring kuyruk derinliği
+        size_t maxPendingFiles = 8;   // Okunmuş ama decode edilmemiş dosya sayısı
+        size_t maxReadyImages = 8;    // Decode edilmiş ama işlenmemiş görüntü sayısı
+        bool useIoUring = true;
+        DropoutChannel dropout = DropoutChannel::None;  // Renkli açıp sadece bu kanalı ver
+        int pinFirstSlot = -1;        // >= 0: k'ıncı decode thread'i bu + k çekirdeğine sabitlenir
+    };
+
+    struct Item {
+        size_t index = 0;
+        std::string path;
+        cv::Mat gray;           // Okuma / decode hatasında boş
+        double readMs = 0.0;
+        double decodeMs = 0.0;
+    };
+
+    struct Stats {
+        double ioWaitMs = 0.0;        // Okuyucuların G/Ç beklediği toplam süre
+        double decodeMs = 0.0;        // Decode thread'lerinin toplam CPU süresi
+        double consumerWaitMs = 0.0;  // Worker'ların hazır görüntü beklediği toplam süre
+        uint64_t bytesRead = 0;
+        bool usedIoUring = false;
+    };
+
+    ImagePrefetcher(const std::vector<std::string>& paths, const Options& opt);
+    ~ImagePrefetcher();
+
+    ImagePrefetcher(const ImagePrefetcher&) = delete;
+    ImagePrefetcher& operator=(const ImagePrefetcher&) = delete;
+
+    // Sıradaki hazır görüntüyü verir; tüm dosyalar bittiğinde false (thread-safe)
+    bool next(Item& out);
+
+    Stats stats() const;
+
+private:
+    struct RawFile {
+        size_t index = 0;
+        std::vector<uchar> bytes;
+        double readMs = 0.0;
+        bool ok = false;
+    };
+
+    void readLoopBlocking();
+    bool readLoopUring();   // io_uring kurulamazsa false
+    void decodeLoop();
+    void finishReader();
+
+    static void addMs(std::atomic<int64_t>& acc, double ms) {
+        acc += static_cast<int64_t>(ms * 1000.0);
+    }
+
+    std::vector<std::string> paths_;
+    Options opt_;
+
+    BoundedQueue<RawFile> rawQueue_;
+    BoundedQueue<Item> readyQueue_;
+
+    std::atomic<size_t> nextPath_{0};
+    std::atomic<int> activeReaders_{0};
+    std::atomic<int> activeDecoders_{0};
+
+    std::atomic<int64_t> ioWaitUs_{0};
+    std::atomic<int64_t> decodeUs_{0};
+    std::atomic<int64_t> consumerWaitUs_{0};
+    std::atomic<uint64_t> bytesRead_{0};
+    std::atomic<bool> usedIoUring_{false};
+
+    std::vector<std::thread> threads_;
+};
+
+}
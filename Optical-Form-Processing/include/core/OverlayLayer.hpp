@@ -0,0 +1,42 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace core {
+
+// Sonuç ekranı gibi değişmeyen overlay'ler için saklanan katman.
+// İçerik değiştiğinde bir kez renk + alfa görüntüsüne çizilir; her karede sadece
+// dolu alanın sınır kutusu üzerinde tek bir karışım (blend) yapılır.
+class OverlayLayer {
+public:
+    // Katman bu kare boyutu için çizilmiş ve geçerli mi
+    bool valid(cv::Size frameSize) const { return valid_ && canvas_.size() == frameSize; }
+    void invalidate() { valid_ = false; }
+
+    // Yeniden çizime başlar (tuval ve alfa temizlenir)
+    void begin(cv::Size frameSize);
+    // Çizim bitti: karışım yapılacak sınır kutusu hesaplanır
+    void end();
+
+    // Çizim yardımcıları (alpha: 0..1 opaklık)
+    void putText(const std::string& text, cv::Point org, double fontScale,
+                 const cv::Scalar& color, int thickness, double alpha = 1.0);
+    void fillRect(const cv::Rect& r, const cv::Scalar& color, double alpha);
+    void rectangle(const cv::Rect& r, const cv::Scalar& color, int thickness, double alpha = 1.0);
+    void line(cv::Point a, cv::Point b, const cv::Scalar& color, int thickness, double alpha = 1.0);
+
+    // frame = frame * (1 - a) + tuval * a (yalnızca sınır kutusu içinde)
+    void composite(cv::Mat& frame) const;
+
+    cv::Size size() const { return canvas_.size(); }
+
+private:
+    static uchar alphaByte(double a) { return cv::saturate_cast<uchar>(a * 255.0); }
+
+    cv::Mat canvas_;   // CV_8UC3
+    cv::Mat alpha_;    // CV_8U
+    cv::Rect bounds_;  // Alfa > 0 olan alanın sınır kutusu
+    bool valid_ = false;
+};
+
+}
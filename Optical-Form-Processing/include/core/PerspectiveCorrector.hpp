@@ -9,7 +9,9 @@ struct WarpResult {
     bool ok = false;
     cv::Mat warped;             
     cv::Mat debug;              
-    std::array<cv::Point2f,4> corners{}; 
+    std::array<cv::Point2f,4> corners{}; // Kağıt sırasında (TL, TR, BR, BL)
+    int quarterTurns = 0;
+    bool scanAligned = false;   // Tarayıcı hızlı yolu kullanıldı (gri çıkış, iyileştirme yok)
 };
 
 class PerspectiveCorrector {
@@ -18,9 +20,40 @@ public:
     
     WarpResult findAndWarp(const cv::Mat& bgr, bool wantDebug) const;
 
+    // Sadece kare içindeki pencerede arar (bkz. SearchWindow); köşeler tam kare koordinatında
+    // döner, debug görüntüsü kare boyutundadır (pencere çerçevesiyle işaretli)
+    WarpResult findAndWarp(const cv::Mat& frame, bool wantDebug, const cv::Rect& window) const;
+
+    // Tarayıcı girişi için hızlı yol (bkz. CornerFinder::processScan): perspektif kestirimi ve
+    // bilateral / CLAHE iyileştirmesi atlanır, çıkış gridir. Kağıt benzerlik dönüşümüne
+    // uymazsa findAndWarp ile tam yola düşer.
+    WarpResult alignScan(const cv::Mat& image) const;
+
+    // Yön tespiti (bkz. CornerFinder)
+    void setLayoutSignature(const cv::Mat& signature) { finder_.setLayoutSignature(signature); }
+    void setOrientationOverride(int quarterTurns) { finder_.setOrientationOverride(quarterTurns); }
+    int orientationOverride() const { return finder_.orientationOverride(); }
+
+    // Çıkış referans boyuttan (1600x2200) küçükse iyileştirme filtreleri bu oranla küçülür
+    void setKernelScale(double scale) { kernelScale_ = scale; }
+
+    // Lens bozulması perspektif düzeltmesine katlanır (boş profil: kapalı)
+    void setCameraProfile(const CameraProfile& cam) { camera_ = cam; }
+    bool hasCameraProfile() const { return !camera_.empty(); }
+
+    // Dropout kanalı: köşe arama ve warp bu kanalda yapılır; grid kanalda görünmediğinden
+    // bilateral / CLAHE / keskinleştirme atlanır ve çıkış gri döner
+    void setDropoutChannel(DropoutChannel c) { finder_.setDropoutChannel(c); }
+    DropoutChannel dropoutChannel() const { return finder_.dropoutChannel(); }
+
 private:
+    // img, frameSize boyutundaki karenin origin'den başlayan parçası
+    WarpResult warpImpl(const cv::Mat& img, bool wantDebug, cv::Size frameSize, cv::Point origin) const;
+
     int outW_, outH_;
+    double kernelScale_ = 1.0;
     CornerFinder finder_;
+    CameraProfile camera_;
 };
 
 }
\ No newline at end of file
@@ -5,7 +5,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include "BubbleDetector.hpp"
+#include "DarknessMap.hpp"
+#include "DecodeTrace.hpp"
+
+namespace core { class FixedGridScorer; }
 
 class ROIDetector {
 public:
@@ -13,6 +18,12 @@ public:
         GRID,
         COLUMN
     };
+
+    // Bubble puanlama yöntemi
+    enum ScoringMode {
+        SCORE_THRESHOLD,   // Bölge başına blur + adaptif eşik + doluluk oranı (varsayılan)
+        SCORE_DARKNESS     // Sayfa başına kağıt beyazı haritası + integral görüntü, tek eşik
+    };
     
     struct RegionDef {
         std::string name;
@@ -33,8 +44,17 @@ public:
     
     ROIDetector();
     
-    // Temel işleme
-    std::map<std::string, std::string> process(const cv::Mat& warped, cv::Mat& debugOut);
+    // Temel işleme (görsel üretmez; debug modunda lastTrace() doldurulur)
+    std::map<std::string, std::string> process(const cv::Mat& warped);
+
+    // Sadece tc_kimlik / ogrenci_no alanlarını okur (batch tekrar tarama kontrolü için ucuz ön okuma)
+    std::map<std::string, std::string> processIdentity(const cv::Mat& warped);
+
+    // Ön okumanın devamı: known'daki bölgeler tekrar çözülmez, sonuca aynen eklenir (hücre
+    // skoru / iz tutulmaz). warped son processIdentity'ye verilen tamponsa gri dönüşüm ve
+    // karanlık haritası o çağrıdan kullanılır (sayfa başına bir kez kurulur).
+    std::map<std::string, std::string> process(const cv::Mat& warped,
+                                               const std::map<std::string, std::string>& known);
     
     // Detaylı analiz - her sorunun durumunu döndürür
     std::map<std::string, std::vector<QuestionDetail>> processWithDetails(
@@ -48,16 +68,104 @@ public:
     
     double getFillThreshold() const { return fillThreshold_; }
     
-    // Debug ÇõŽñktŽñsŽñ iÇõin
+    // Ders gridlerinde düşük çözünürlük -> belirsiz satırlar tam çözünürlük kaskadı.
+    // Varsayılan kapalı; açmadan önce omr_bench'in kaskad karşılaştırmasına bakın (bkz. BubbleDetector)
+    void setCascade(bool enabled) { bubbleDetector_.setCascade(enabled); }
+    const BubbleDetector::CascadeStats& cascadeStats() const { return bubbleDetector_.cascadeStats(); }
+
+    void setScoringMode(ScoringMode mode);
+    ScoringMode getScoringMode() const { return scoringMode_; }
+
+    // Warp dropout kanalından (bkz. core::DropoutChannel) geliyorsa grid yoktur: bölge başına
+    // eşik / açma / aşındırma ve kenar payları atlanır, tüm alanlar karanlık skoruyla okunur.
+    // Basılı harfler de kaybolduğundan bubble'ın tamamı tam ağırlıkla sayılır.
+    void setDropoutMode(bool enabled);
+    bool isDropoutMode() const { return dropout_; }
+
+    // SCORE_DARKNESS: şablon standart form (core::kStandardForm) ve warp bir ön ayar boyutundaysa
+    // derleme zamanında özelleşmiş skor çekirdeği kullanılır (varsayılan açık, sonuç aynı)
+    void setFixedLayout(bool enabled) { fixedLayout_ = enabled; }
+    bool isFixedLayoutEnabled() const { return fixedLayout_; }
+
+    // Varsayılan şablonu değiştirir (bkz. core::parseTemplateJson).
+    // subjects: cevap gridi olarak okunacak bölge adları; "tc_kimlik", "ogrenci_no" ve
+    // "adi_soyadi" adlı bölgeler kimlik okuyucularıyla, diğerleri tek sütun olarak okunur.
+    void setTemplate(const std::vector<RegionDef>& regions, const std::set<std::string>& subjects);
+    const std::vector<RegionDef>& regions() const { return regions_; }
+    const std::set<std::string>& subjectNames() const { return subjectNames_; }
+
+    // Şablondaki en küçük hücre aralığı (form genişliği / yüksekliği oranı).
+    // Warp boyutu buradan türetilir (bkz. core::makeWarpProfile).
+    cv::Size2f minCellPitch() const;
+
+    // Warp referans boyuttan (1600x2200) farklıysa blur / eşik çekirdekleri bu oranla ölçeklenir
+    void setWarpScale(double scale);
+    double getWarpScale() const { return warpScale_; }
+
+    // Bölge dikdörtgenlerinden üretilen yerleşim imzası (bölge içi 1, dışı 0).
+    // Form asimetrik olduğundan ters / yan tutulmuş kağıdın yönünü bulmakta kullanılır.
+    cv::Mat layoutSignature(cv::Size size = cv::Size(32, 44)) const;
+
+    // Ardışık karelerde çoklu kare füzyonu (canlı mod). Kararı settleFrames kare
+    // boyunca değişmeyen bölgeler "oturur" ve yeni kağıda kadar tekrar okunmaz.
+    void setTemporalFusion(bool enabled, int settleFrames = 5);
+    bool isTemporalFusionEnabled() const { return temporalFusion_; }
+    void resetTemporalState();   // Kağıt değiştiğinde / kaybolduğunda
+    bool allRegionsSettled() const;
+
+    // Açıksa process() ders gridlerinin hücre skorlarını saklar (analiz / Python bağlaması).
+    // Her bölge için rows x cols CV_64F; Mat başlıkları paylaşımlıdır, sonraki process()
+    // yeni tampon ayırır, önceki skorlara tutulan referanslar geçerli kalır.
+    // Füzyonda oturmuş ders gridleri için kararı veren doluluk EMA'sı saklanır.
+    void setCellScoreCapture(bool enabled) { captureScores_ = enabled; cellScores_.clear(); }
+    const std::map<std::string, cv::Mat>& cellScores() const { return cellScores_; }
+
+    // Debug: okuma sırasında hücre skorları / seçimler kompakt iz olarak saklanır.
+    // Kapalıyken iz kodu okuma döngülerinden derleme zamanında çıkarılır.
+    // Füzyonda oturmuş ders gridleri EMA skorları ve seçimleriyle yer alır; oturmuş kimlik /
+    // tek sütun alanları sadece çerçeveyle (skor ve seçim yok, değer önceki karelerden).
     void setDebugMode(bool enabled);
-    cv::Mat getLastDebugVisualization() const;
+    const core::DecodeTrace& lastTrace() const { return trace_; }
 
 private:
     std::vector<RegionDef> regions_;
+    std::set<std::string> subjectNames_ = {
+        "turkce", "sosyal", "din", "ingilizce", "matematik", "fen"
+    };
     double fillThreshold_;
     BubbleDetector bubbleDetector_;
     bool debugMode_;
-    cv::Mat lastDebugVis_;
+    core::DecodeTrace trace_;
+
+    double warpScale_ = 1.0;
+
+    ScoringMode scoringMode_ = SCORE_THRESHOLD;            // Etkin mod (dropout'ta karanlık)
+    ScoringMode requestedScoringMode_ = SCORE_THRESHOLD;   // setScoringMode ile istenen mod
+    bool dropout_ = false;
+    core::DarknessMap darkness_;   // process() başında sayfa başına bir kez kurulur
+    cv::Mat identitySource_;       // Son processIdentity girdisi (başlık tamponu canlı tutar)
+    cv::Mat identityGray_;         // ve onun gri hali; darkness_ bundan kuruldu
+
+    bool fixedLayout_ = true;
+    bool standardForm_ = true;     // Şablon core::kStandardForm ile birebir aynı mı
+    const core::FixedGridScorer* fixedKernel_ = nullptr;   // Bu sayfa için seçilen çekirdek
+    bool matchesStandardForm() const;
+
+    bool captureScores_ = false;
+    std::map<std::string, cv::Mat> cellScores_;
+    void storeCellScores(const std::string& name, const std::vector<std::vector<double>>& ratios);
+
+    // Ders cevaplarında "işaretli" sayılma güveni (0-100)
+    static constexpr double kAnswerConfidence = 60.0;
+
+    // Temporal füzyon (ders bölgeleri BubbleDetector'da, diğer alanlar burada)
+    struct FieldHistory {
+        std::string value;
+        int stableFrames = 0;
+    };
+    bool temporalFusion_ = false;
+    int settleFrames_ = 5;
+    std::map<std::string, FieldHistory> fieldHistory_;
     
     // Helper fonksiyonlar
     std::vector<QuestionDetail> analyzeGridWithDetails(
@@ -69,6 +177,22 @@ private:
         char firstLabel = 'A'
     );
     
+    // Tek bir bölgeyi okur. Debug=true: hücre skorları ve seçimler trace'e yazılır
+    // (false örneğinde bu kod hiç derlenmez)
+    template <bool Debug>
+    bool decodeRegion(const cv::Mat& gray, const RegionDef& reg, double idThr,
+                      std::string& val, core::RegionTrace* trace);
+
+    // SCORE_DARKNESS modunda bölge okuması
+    template <bool Debug>
+    std::string decodeRegionDarkness(const RegionDef& reg, const cv::Rect& roi,
+                                     bool subjectGrid, core::RegionTrace* trace);
+
+    template <bool Debug>
+    std::map<std::string, std::string> decodeRegions(const cv::Mat& gray, bool identityOnly,
+                                                     const std::map<std::string, std::string>* known = nullptr,
+                                                     bool darknessReady = false);
+
     bool isSubjectRegion(const std::string& name) const;
     std::string bubblesToAnswerString(const std::vector<BubbleResult>& results) const;
 };
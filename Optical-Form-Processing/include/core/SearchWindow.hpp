@@ -0,0 +1,55 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <array>
+
+namespace core {
+
+// Canlı modda kağıt kilitlendikten sonra aranacak kare bölgesi.
+//
+//  Kilitli değil : Tüm kare taranır.
+//  Kilitli       : Son köşelerin sınır kutusu + pay kadar pencere; gri dönüşüm ve köşe
+//                  arama sadece bu pencerede çalışır (kalite kapısı tam kareden küçük örnek
+//                  alır). Pencere köşeler kenara yaklaşmadıkça sabit kalır.
+//                  Her sweepEvery karede bir tam tarama yapılır;
+//                  pencerede art arda maxMisses kez kağıt bulunamazsa kilit bırakılır.
+class SearchWindow {
+public:
+    struct Params {
+        double margin = 0.20;    // Sınır kutusunun her yanına eklenen pay (kutunun büyük kenarına oran)
+        int minMarginPx = 48;
+        int sweepEvery = 30;     // Tam tarama aralığı (kare); 0 ise hiç
+        int maxMisses = 2;
+    };
+
+    SearchWindow() = default;
+    explicit SearchWindow(const Params& p) : params_(p) {}
+
+    // Bu karede aranacak bölge (kare koordinatında, kareye kırpılmış)
+    cv::Rect next(cv::Size frameSize);
+
+    // Aramanın sonucu; köşeler tam kare koordinatında
+    void update(bool found, const std::array<cv::Point2f, 4>& corners);
+
+    void reset();
+
+    bool isLocked() const { return locked_; }
+    bool lastWasFullFrame() const { return fullFrame_; }
+    const cv::Rect& window() const { return window_; }
+
+    void setEnabled(bool on) { enabled_ = on; if (!on) reset(); }
+    bool isEnabled() const { return enabled_; }
+
+private:
+    cv::Rect windowFor(const cv::Rect& bounds) const;
+
+    Params params_;
+    bool enabled_ = true;
+    bool locked_ = false;
+    bool fullFrame_ = true;
+    cv::Size frameSize_;
+    cv::Rect window_;
+    int sinceSweep_ = 0;
+    int misses_ = 0;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <string>
+
+#include "AnswerKey.hpp"
+#include "PerspectiveCorrector.hpp"
+#include "ROIDetector.hpp"
+#include "WarpProfile.hpp"
+
+namespace core {
+
+// Tek kağıdı uçtan uca işleyen sınıf: warp -> ROI okuma -> puanlama.
+// Thread-safe DEĞİLDİR; her worker kendi örneğini kullanır.
+class SheetGrader {
+public:
+    SheetGrader(const AnswerKey& key, const WarpProfile& profile, double fillThreshold);
+
+    // Köşeleri bulup formu düzleştirir (başarısızsa false).
+    // scanAligned: tarayıcı hızlı yolu kullanıldıysa true (bkz. setScannerMode)
+    bool warp(const cv::Mat& image, cv::Mat& warped, bool* scanAligned = nullptr) const;
+
+    // Sadece kimlik alanlarını okur
+    std::map<std::string, std::string> readIdentity(const cv::Mat& warped);
+
+    // Tüm alanları okur ve puanlar
+    std::map<std::string, std::string> readAll(const cv::Mat& warped);
+
+    // readIdentity sonrası: kimlik alanları tekrar okunmaz, sayfa hazırlığı paylaşılır
+    std::map<std::string, std::string> readAll(const cv::Mat& warped,
+                                               const std::map<std::string, std::string>& identity);
+    AnswerKey::ScoreResult score(const std::map<std::string, std::string>& answers);
+
+    void setScoringMode(ROIDetector::ScoringMode mode) { detector_.setScoringMode(mode); }
+
+    // Düz tarayıcı girişi: önce benzerlik dönüşümlü hızlı yol denenir (PerspectiveCorrector::alignScan)
+    void setScannerMode(bool on) { scannerMode_ = on; }
+
+    // Dropout mürekkepli formlar: warp bu kanaldan, okuma temizliksiz karanlık skoruyla
+    void setDropoutChannel(DropoutChannel c) {
+        pc_.setDropoutChannel(c);
+        detector_.setDropoutMode(c != DropoutChannel::None);
+    }
+
+    // Varsayılan yerine özel form şablonu (yön imzası da yeniden üretilir)
+    void setTemplate(const std::vector<ROIDetector::RegionDef>& regions,
+                     const std::set<std::string>& subjects);
+
+private:
+    AnswerKey key_;
+    PerspectiveCorrector pc_;
+    ROIDetector detector_;
+    bool scannerMode_ = false;
+};
+
+}
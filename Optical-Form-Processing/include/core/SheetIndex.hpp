@@ -0,0 +1,84 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AnswerKey.hpp"
+
+namespace core {
+
+// Warp edilmiş formun ucuz parmak izi.
+// coarse: 8x8 blok ortalama hash (kaba kova anahtarı)
+// thumb : 1/16 ölçekli normalize küçük resim (işaret farklarını yakalayan doğrulama)
+struct SheetFingerprint {
+    uint64_t coarse = 0;
+    cv::Mat thumb;
+};
+
+SheetFingerprint computeFingerprint(const cv::Mat& warpedGray);
+
+// İki parmak izi aynı kağıdın tekrar taranmış hali mi?
+bool isSameScan(const SheetFingerprint& a, const SheetFingerprint& b);
+
+// Bir kağıdın okunmuş sonucu (tekrar taramalar bunu paylaşır)
+struct SheetOutcome {
+    bool ok = false;
+    std::map<std::string, std::string> answers;
+    AnswerKey::ScoreResult score;
+};
+
+// Batch sırasında tc_kimlik / ogrenci_no anahtarlı, thread-safe kağıt indeksi.
+// Her kağıt okunmadan ÖNCE claim() ile kaydolur; böylece aynı anda işlenen
+// bir tekrar tarama, orijinalin sonucunu bekler ve tekrar decode edilmez.
+class SheetIndex {
+public:
+    enum class ClaimKind {
+        New,          // İlk kez görülüyor -> tam okuma yapılmalı
+        Rescan,       // Aynı kağıt tekrar taranmış -> okuma atlanır
+        DuplicateId   // Aynı kimlik, farklı kağıt -> okunur ve incelemeye işaretlenir
+    };
+
+    struct Claim {
+        ClaimKind kind = ClaimKind::New;
+        std::string originalPath;                    // Rescan / DuplicateId için ilk dosya
+        std::shared_future<SheetOutcome> original;   // Rescan için orijinal sonuç
+        std::shared_ptr<std::promise<SheetOutcome>> promise; // New / DuplicateId için doldurulacak
+    };
+
+    // idKey boşsa sadece parmak izi ile karşılaştırılır
+    Claim claim(const std::string& idKey,
+                const SheetFingerprint& fp,
+                const std::string& path);
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::string path;
+        SheetFingerprint fp;
+        std::shared_future<SheetOutcome> outcome;
+    };
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, std::vector<Entry>> byId_;
+    std::unordered_map<uint64_t, std::vector<Entry>> byHash_; // kimliksiz kağıtlar
+
+    // byHash_ anahtarlarının bant indeksi: 64 bitlik hash kHashBands banda bölünür, her bant
+    // değeri o bandı taşıyan kova anahtarlarına gider. Kimliksiz sorgu sadece kendi bant
+    // değerleri ve bunların 1 bit komşularını yoklar (bkz. SheetIndex.cpp)
+    static constexpr int kHashBands = 6;
+    std::array<std::unordered_map<uint32_t, std::vector<uint64_t>>, kHashBands> hashBands_;
+};
+
+// Kimlik alanlarından indeks anahtarı üretir ("-" haneler yok sayılır).
+// Hiç hane okunamadıysa boş döner.
+std::string makeIdentityKey(const std::map<std::string, std::string>& identity);
+
+}
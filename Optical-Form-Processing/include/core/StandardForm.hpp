@@ -0,0 +1,30 @@
+#pragma once
+#include "FormLayout.hpp"
+
+namespace core {
+
+// Varsayılan (en çok basılan) optik form. ROIDetector'ın varsayılan şablonu buradan kurulur;
+// aynı tanım derleme zamanı skor çekirdeklerini üretir.
+inline constexpr LayoutDesc<9> kStandardForm{{{
+    // TC: 10 satır (0..9) x 11 sütun (11 hane)
+    {"tc_kimlik",  {0.0065f, 0.283f, 0.271f, 0.172f}, 10, 11, FieldKind::Digits,  true},
+    // Öğrenci No: 10 satır (0..9) x 5 sütun
+    {"ogrenci_no", {0.287f,  0.283f, 0.123f, 0.172f}, 10, 5,  FieldKind::Digits,  true},
+    // Ad Soyad: 29 satır (A-Z) x 21 sütun
+    {"adi_soyadi", {0.000f,  0.490f, 0.520f, 0.495f}, 29, 21, FieldKind::Letters, true},
+
+    {"turkce",     {0.525f,  0.263f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+    {"sosyal",     {0.640f,  0.263f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+    {"din",        {0.755f,  0.263f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+    {"ingilizce",  {0.874f,  0.263f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+
+    // Matematik ve Fen (Aynı hizayı korur)
+    {"matematik",  {0.641f,  0.640f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+    {"fen",        {0.757f,  0.640f, 0.125f, 0.345f}, 20, 4,  FieldKind::Answers, true},
+}}};
+
+// Standart form için bu warp boyutunda derlenmiş çekirdek; yoksa nullptr.
+// Çekirdekler her hız ön ayarının warp boyutu için üretilir (OMR_FIXED_LAYOUT kapalıysa hiç).
+const FixedGridScorer* standardFormKernel(cv::Size warpSize);
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <set>
+#include <string>
+#include <vector>
+
+#include "AnswerKey.hpp"
+#include "ROIDetector.hpp"
+
+namespace core {
+
+// Form şablonu (JSON):
+// {
+//   "regions": [
+//     { "name": "tc_kimlik", "rect": [0.0065, 0.283, 0.271, 0.172], "rows": 10, "cols": 11 },
+//     { "name": "turkce",    "rect": [0.525, 0.263, 0.125, 0.345],  "rows": 20, "cols": 4, "subject": true },
+//     { "name": "oturum",    "rect": [...], "rows": 4, "cols": 1, "type": "column" }
+//   ]
+// }
+// rect: form genişliği / yüksekliğine oranla {x, y, w, h}
+struct FormTemplate {
+    std::vector<ROIDetector::RegionDef> regions;
+    std::set<std::string> subjects;
+};
+
+bool parseTemplateJson(const std::string& json, FormTemplate& out, std::string& err);
+
+// Cevap anahtarı (JSON): ders adı -> cevap dizisi, soru sırasıyla
+// { "turkce": "CBAABDBCCCCDABABCAAD", "sosyal": "BBDA..." }
+bool parseAnswerKeyJson(const std::string& json,
+                        std::vector<AnswerKey::QuestionAnswer>& out,
+                        std::string& err);
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+
+namespace core {
+
+// Çekirdek bütçesi: OpenCV'nin kendi thread havuzu (parallel_for_: bilateralFilter,
+// warpPerspective, adaptiveThreshold...) ile bizim worker / decode thread'lerimiz aynı
+// çekirdekleri paylaşır. İkisi birden tam açılırsa çekirdekler aşırı abone olur.
+//   Canlı:  tek kağıt akışı -> kağıt içi paralellik (OpenCV tüm çekirdekler)
+//   Batch:  kağıtlar arası paralellik -> worker + decode çekirdekleri doldurur, OpenCV
+//           sadece boşta kalan payı (çoğunlukla 1 thread) kullanır
+enum class WorkMode { Live, Batch };
+
+struct ThreadRequest {
+    WorkMode mode = WorkMode::Live;
+    int workers = 0;         // 0 -> otomatik (batch)
+    int decodeThreads = 0;   // 0 -> otomatik (batch)
+    size_t jobs = 0;         // Batch'teki kağıt sayısı (0: bilinmiyor); worker sayısını sınırlar
+    bool pin = false;        // Worker / decode thread'lerini çekirdeklere sabitle
+};
+
+struct ThreadPlan {
+    int cores = 1;           // Sürecin kullanabileceği çekirdek (affinity maskesi dahil)
+    int opencvThreads = 1;   // cv::setNumThreads
+    int workers = 1;         // Kağıt worker'ları
+    int decodeThreads = 0;   // Batch decode thread'leri (okuyucular G/Ç beklediği için sayılmaz)
+    bool pin = false;        // Sadece opencvThreads == 1 iken (bkz. pinCurrentThread)
+};
+
+// Süreç başındaki affinity maskesindeki çekirdek sayısı (ilk çağrıda okunur)
+int availableCores();
+
+ThreadPlan planThreads(const ThreadRequest& req);
+
+// cv::setNumThreads uygular; önceki değeri döndürür (geri almak için)
+int applyThreadPlan(const ThreadPlan& plan);
+
+// applyThreadPlan'in kapsamlı hali: yıkıcı önceki cv::setNumThreads değerini geri yükler,
+// böylece istisna ile çıkılsa da süreçteki OpenCV ayarı planın değerinde kalmaz
+class ScopedThreadPlan {
+public:
+    explicit ScopedThreadPlan(const ThreadPlan& plan);
+    ~ScopedThreadPlan();
+
+    ScopedThreadPlan(const ScopedThreadPlan&) = delete;
+    ScopedThreadPlan& operator=(const ScopedThreadPlan&) = delete;
+
+private:
+    int prevOpencvThreads_;
+};
+
+// Çağıran thread'i slot'uncu kullanılabilir çekirdeğe sabitler (Linux; diğerlerinde false).
+// OpenCV havuz thread'leri onları ilk başlatan thread'in maskesini devraldığından sabitleme
+// yalnızca OpenCV tek thread çalışırken yapılır.
+bool pinCurrentThread(int slot);
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "FrameSource.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// "grey" | "yuyv" | "nv12"
+bool parseLumaFormat(const std::string& s, LumaFormat& out);
+const char* lumaFormatName(LumaFormat f);
+
+// Ham karedeki Y düzlemini gri Mat olarak verir.
+// GREY ve NV12'de kopyasız görünümdür (frame tampona işaret eder); YUYV'de Y baytları
+// araya girmiş olduğundan frame tamponuna tek kanal çıkarılır (aynı boyutta yeniden ayırma yok).
+void lumaView(const uchar* data, LumaFormat fmt, cv::Size size, size_t stride, cv::Mat& frame);
+
+struct V4l2Options {
+    std::string device = "/dev/video0";
+    cv::Size size{1920, 1080};
+    double fps = 30.0;
+    LumaFormat format = LumaFormat::Yuyv;
+    int bufferCount = 4;
+};
+
+// Linux V4L2 kamerası. Sürücü tamponları mmap edilir ve kare, Y düzleminin gri görünümü
+// olarak verilir: VideoCapture'ın BGR dönüşümü ve ardından tekrar griye çevirme yapılmaz.
+// Kare bir sonraki read() çağrısına kadar geçerlidir; tampon sürücüye o zaman geri verilir.
+class V4l2CameraSource : public FrameSource {
+public:
+    explicit V4l2CameraSource(const V4l2Options& opt);
+    ~V4l2CameraSource() override;
+
+    V4l2CameraSource(const V4l2CameraSource&) = delete;
+    V4l2CameraSource& operator=(const V4l2CameraSource&) = delete;
+
+    bool isOpened() const { return streaming_; }
+    const std::string& error() const { return err_; }
+
+    bool read(cv::Mat& frame) override;
+    // Sürücü zaman damgası (yakalama anı, ilk kare ~0)
+    double timestampMs() const override { return tsMs_; }
+    bool isLive() const override { return true; }
+    std::string describe() const override;
+
+    // Sürücünün kabul ettiği değerler (istenenden farklı olabilir)
+    cv::Size frameSize() const { return size_; }
+    int bufferCount() const { return static_cast<int>(buffers_.size()); }
+    // Sıra numarasındaki boşluklardan sayılan kaçırılmış kareler
+    long droppedFrames() const { return dropped_; }
+
+private:
+    struct Buffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    bool fail(const std::string& what);
+    void shutdown();
+
+    V4l2Options opt_;
+    int fd_ = -1;
+    std::vector<Buffer> buffers_;
+    int held_ = -1;          // Kullanıcıda olan tamponun indeksi
+    cv::Size size_;
+    size_t stride_ = 0;
+    bool streaming_ = false;
+    std::string err_;
+
+    double tsMs_ = 0.0;
+    double ts0Ms_ = -1.0;
+    long lastSeq_ = -1;
+    long dropped_ = 0;
+};
+
+// Kaydedilmiş ham kamera akışı (ör. v4l2-ctl --stream-to ile alınan YUYV).
+// V4L2 kaynağıyla aynı yoldan Y düzlemi verilir; kamerasız test ve ölçüm içindir.
+class RawLumaFileSource : public FrameSource {
+public:
+    RawLumaFileSource(const std::string& path, LumaFormat fmt, cv::Size size, double fps, Pacing pacing);
+
+    bool isOpened() const { return in_.is_open() && frameBytes_ > 0; }
+    bool read(cv::Mat& frame) override;
+    double timestampMs() const override { return tsMs_; }
+    bool isLive() const override { return false; }
+    std::string describe() const override;
+
+private:
+    std::ifstream in_;
+    std::string path_;
+    LumaFormat fmt_;
+    cv::Size size_;
+    size_t stride_ = 0;
+    size_t frameBytes_ = 0;
+    cv::Mat raw_;            // Tek kare ham tampon (bir kez ayrılır)
+    ReplayPacer pacer_;
+    double fps_;
+    long index_ = 0;
+    double tsMs_ = 0.0;
+};
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <string>
+
+namespace core {
+
+// Blur / eşik / morfoloji çekirdekleri bu warp boyutunda ayarlandı
+constexpr int kReferenceWarpW = 1600;
+constexpr int kReferenceWarpH = 2200;
+
+// Bubble çapı / hücre aralığı (çizimdeki yarıçap = 0.35 * hücre ile aynı)
+constexpr double kBubbleToPitch = 0.70;
+
+// Bu genişliğin altında köşe işaretleri ve kimlik alanları güvenilmez olur
+constexpr int kMinWarpW = 400;
+
+// Hız / doğruluk ön ayarları: warp'ta hedeflenen bubble çapı (piksel)
+enum class SpeedPreset {
+    Fast,       // ~9 px
+    Balanced,   // ~13 px (referans boyutun ~1/4'ü kadar piksel)
+    Accurate    // Referans 1600x2200 (ölçek 1.0: çekirdekler ayarlandıkları boyutta, ~26 px)
+};
+
+// Şablondan türetilen warp boyutu ve çekirdek ölçeği
+struct WarpProfile {
+    int width = kReferenceWarpW;
+    int height = kReferenceWarpH;
+    double scale = 1.0;      // width / kReferenceWarpW
+    double bubblePx = 0.0;   // Warp'taki yaklaşık bubble çapı
+
+    cv::Size size() const { return cv::Size(width, height); }
+};
+
+// Referans boyutta ayarlanmış çekirdeği ölçekler.
+// odd=true: blur / adaptiveThreshold blok boyutu (tek, en az 3)
+// odd=false: morfoloji çekirdeği (en az 1)
+int scaledKernel(int base, double scale, bool odd = true);
+
+// std::lround ile aynı (pozitif değerler), derleme zamanında da çalışır
+constexpr int roundHalfAway(double v) {
+    const int i = static_cast<int>(v);
+    return (v - i >= 0.5) ? i + 1 : i;
+}
+
+struct WarpDims {
+    int width;
+    int height;
+};
+
+// makeWarpProfile'ın boyut hesabı. constexpr: derleme zamanı form yerleşimleri aynı
+// boyutu önceden hesaplar (bkz. FormLayout.hpp)
+constexpr WarpDims warpDimsFor(float minPitchW, float minPitchH, double targetBubblePx) {
+    if (minPitchW <= 0.f || minPitchH <= 0.f || targetBubblePx <= 0.0)
+        return {kReferenceWarpW, kReferenceWarpH};
+
+    const double pitchPx = targetBubblePx / kBubbleToPitch;
+    const double aspect = static_cast<double>(kReferenceWarpW) / kReferenceWarpH;
+
+    // Hem yatay hem dikey aralık hedefi karşılamalı
+    double w = std::max(pitchPx / minPitchW, (pitchPx / minPitchH) * aspect);
+    w = std::clamp(w, static_cast<double>(kMinWarpW), static_cast<double>(kReferenceWarpW));
+    return {roundHalfAway(w), roundHalfAway(w / aspect)};
+}
+
+// minPitch: şablondaki en küçük hücre aralığı (form genişliği / yüksekliği oranı).
+// Warp, en küçük hücrede bubble çapı targetBubblePx olacak şekilde boyutlandırılır;
+// en-boy oranı referans formunkiyle aynı kalır, referanstan büyük olmaz.
+WarpProfile makeWarpProfile(const cv::Size2f& minPitch, double targetBubblePx);
+
+constexpr double targetBubblePx(SpeedPreset preset) {
+    switch (preset) {
+        case SpeedPreset::Fast:     return 9.0;
+        case SpeedPreset::Balanced: return 13.0;
+        case SpeedPreset::Accurate: return 26.0;
+    }
+    return 13.0;
+}
+
+// Ön ayardan boyut: Accurate aralıktan hesaplanmaz, referans boyuta sabitlenir (hesap
+// ~1583x2176 verir; ölçek 0.99 tek boyutlu çekirdeklerin yuvarlamasını değiştirirdi)
+constexpr WarpDims warpDimsFor(float minPitchW, float minPitchH, SpeedPreset preset) {
+    if (preset == SpeedPreset::Accurate) return {kReferenceWarpW, kReferenceWarpH};
+    return warpDimsFor(minPitchW, minPitchH, targetBubblePx(preset));
+}
+WarpProfile makeWarpProfile(const cv::Size2f& minPitch, SpeedPreset preset);
+bool parseSpeedPreset(const std::string& s, SpeedPreset& out);
+const char* presetName(SpeedPreset preset);
+
+}
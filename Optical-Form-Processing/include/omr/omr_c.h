@@ -0,0 +1,116 @@
+/*
+ * omr_core C API
+ *
+ * Optik form okuma çekirdeğini GUI / süreç başlatmadan gömmek için kararlı C arayüzü.
+ *
+ *  - Oturum (omr_session) şablon + cevap anahtarından bir kez kurulur; warp boyutu,
+ *    örnekleme maskeleri vb. burada hazırlanır, çağrı başına kurulum maliyeti yoktur.
+ *  - omr_grade_gray() aynı oturum üzerinde farklı thread'lerden eşzamanlı çağrılabilir;
+ *    oturum her eşzamanlı çağrı için bir okuma bağlamını havuzdan verir ve geri alır.
+ *  - API sınırında bellek ayrılmaz: giriş tamponu kopyalanmaz, sonuç çağıranın
+ *    struct'ına, cevap JSON'u çağıranın tamponuna yazılır.
+ */
+#ifndef OMR_C_H
+#define OMR_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(OMR_CORE_SHARED)
+#  ifdef OMR_CORE_BUILD
+#    define OMR_API __declspec(dllexport)
+#  else
+#    define OMR_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define OMR_API __attribute__((visibility("default")))
+#else
+#  define OMR_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OMR_API_VERSION 1
+
+typedef struct omr_session omr_session;
+
+typedef enum omr_status {
+    OMR_OK = 0,
+    OMR_ERR_INVALID_ARG = 1,
+    OMR_ERR_TEMPLATE = 2,          /* Şablon JSON geçersiz */
+    OMR_ERR_KEY = 3,               /* Cevap anahtarı JSON geçersiz */
+    OMR_ERR_NO_PAPER = 4,          /* Köşe işaretleri bulunamadı */
+    OMR_ERR_BUFFER_TOO_SMALL = 5,  /* answers_json tamponu yetersiz (json_len gereken boyut) */
+    OMR_ERR_INTERNAL = 6
+} omr_status;
+
+typedef enum omr_preset {
+    OMR_PRESET_FAST = 0,
+    OMR_PRESET_BALANCED = 1,
+    OMR_PRESET_ACCURATE = 2
+} omr_preset;
+
+typedef enum omr_scoring {
+    OMR_SCORING_THRESHOLD = 0,
+    OMR_SCORING_DARKNESS = 1
+} omr_scoring;
+
+typedef struct omr_options {
+    int preset;             /* omr_preset */
+    int scoring;            /* omr_scoring */
+    double fill_threshold;  /* Varsayılan 0.40 */
+} omr_options;
+
+typedef struct omr_result {
+    int paper_found;
+    int total_questions;
+    int total_correct;
+    int total_wrong;
+    int total_empty;
+    double total_score;
+    char tc_kimlik[32];     /* NUL sonlu; okunamayan hane '-' */
+    char ogrenci_no[32];
+    double elapsed_ms;
+} omr_result;
+
+OMR_API int omr_api_version(void);
+OMR_API const char* omr_status_string(omr_status status);
+
+OMR_API void omr_options_init(omr_options* opt);
+
+/*
+ * template_json: NULL ise yerleşik form şablonu kullanılır.
+ * key_json     : {"ders": "ABCD..."} biçiminde cevap anahtarı (zorunlu).
+ * opt          : NULL ise varsayılanlar.
+ * err / err_cap: İsteğe bağlı hata mesajı tamponu.
+ */
+OMR_API omr_status omr_session_create(const char* template_json,
+                                      const char* key_json,
+                                      const omr_options* opt,
+                                      omr_session** out,
+                                      char* err, size_t err_cap);
+
+OMR_API void omr_session_destroy(omr_session* session);
+
+/* Oturumun warp boyutu (bilgi amaçlı) */
+OMR_API void omr_session_warp_size(const omr_session* session, int* width, int* height);
+
+/*
+ * gray       : 8 bit tek kanallı görüntü, satır adımı stride bayt (kopyalanmaz).
+ * out        : Sonuç (zorunlu).
+ * answers_json / json_cap / json_len: İsteğe bağlı; {"answers": {...}, "subjects": {...}}
+ *              Tampon yetersizse OMR_ERR_BUFFER_TOO_SMALL döner, *json_len gereken boyuttur
+ *              (NUL dahil); out yine doldurulur.
+ */
+OMR_API omr_status omr_grade_gray(omr_session* session,
+                                  const uint8_t* gray, int width, int height, size_t stride,
+                                  omr_result* out,
+                                  char* answers_json, size_t json_cap, size_t* json_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OMR_C_H */
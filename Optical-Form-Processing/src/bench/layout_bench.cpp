@@ -0,0 +1,207 @@
+// Derleme zamanı yerleşim çekirdeği ölçümü (cmake -DOMR_BUILD_BENCH=ON, Release).
+//
+//   ./omr_bench [--image warp.png]... [--iters N]
+//
+// Her hız ön ayarının warp boyutunda standart form için:
+//   - skor: tüm bölgelerin hücre skorları (DarknessMap::scoreGrid / FixedLayoutKernel)
+//   - okuma: SCORE_DARKNESS modunda ROIDetector::process (harita kurulumu dahil)
+//   - kaskad: SCORE_THRESHOLD okumasının tek geçiş / kaskad sonuçları karşılaştırılır
+//     (her görüntüde okunan karakterler birebir aynı olmalı)
+// Görüntü verilmezse sentetik sayfa üretilir. İki yolun skorları karşılaştırılır.
+
+#include <opencv2/opencv.hpp>
+#include "ROIDetector.hpp"
+#include "StandardForm.hpp"
+#include "WarpProfile.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Kağıt beyazı + gürültü; her ders satırında rastgele bir şık dolu
+cv::Mat syntheticPage(cv::Size size, cv::RNG& rng) {
+    cv::Mat page(size, CV_8UC1);
+    rng.fill(page, cv::RNG::UNIFORM, 215, 245);
+
+    for (const auto& d : core::kStandardForm.regions) {
+        if (d.kind != core::FieldKind::Answers) continue;
+        const cv::Rect roi = core::regionRoi(d.rect, d.grid, true, size.width, size.height).rect();
+        const float cw = static_cast<float>(roi.width) / d.cols;
+        const float ch = static_cast<float>(roi.height) / d.rows;
+        for (int r = 0; r < d.rows; ++r) {
+            const int c = rng.uniform(0, d.cols);
+            cv::Point center(cvRound(roi.x + (c + 0.5f) * cw), cvRound(roi.y + (r + 0.5f) * ch));
+            cv::circle(page, center, std::max(1, cvRound(0.3f * std::min(cw, ch))), cv::Scalar(40), -1);
+        }
+    }
+    return page;
+}
+
+// İki okuma arasında farklı okunan karakter sayısı (eksik alan tüm uzunluğuyla sayılır)
+int countDisagreements(const std::map<std::string, std::string>& a,
+                       const std::map<std::string, std::string>& b) {
+    int diff = 0;
+    for (const auto& kv : a) {
+        auto it = b.find(kv.first);
+        const std::string other = (it == b.end()) ? std::string() : it->second;
+        const size_t n = std::max(kv.second.size(), other.size());
+        for (size_t i = 0; i < n; ++i) {
+            const char x = i < kv.second.size() ? kv.second[i] : '\0';
+            const char y = i < other.size() ? other[i] : '\0';
+            if (x != y) ++diff;
+        }
+    }
+    for (const auto& kv : b)
+        if (!a.count(kv.first)) diff += static_cast<int>(kv.second.size());
+    return diff;
+}
+
+template <typename F>
+double msPerIter(int iters, F&& f) {
+    f();   // Isınma
+    auto t0 = Clock::now();
+    for (int i = 0; i < iters; ++i) f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / iters;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> imagePaths;
+    int iters = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--image" && i + 1 < argc) imagePaths.push_back(argv[++i]);
+        else if (a == "--iters" && i + 1 < argc) iters = std::max(1, std::atoi(argv[++i]));
+    }
+
+    std::vector<cv::Mat> sources;
+    for (const auto& path : imagePaths) {
+        cv::Mat img = cv::imread(path, cv::IMREAD_GRAYSCALE);
+        if (img.empty()) {
+            std::cerr << "Goruntu okunamadi: " << path << "\n";
+            return 1;
+        }
+        sources.push_back(img);
+    }
+    const cv::Mat source = sources.empty() ? cv::Mat() : sources.front();
+
+    ROIDetector probe;
+    cv::RNG rng(12345);
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "preset    warp        skor ms (calisma / ozel / kat)    okuma ms (calisma / ozel / kat)   fark\n";
+
+    for (auto preset : {core::SpeedPreset::Fast, core::SpeedPreset::Balanced, core::SpeedPreset::Accurate}) {
+        const core::WarpProfile prof = core::makeWarpProfile(probe.minCellPitch(), preset);
+        const core::FixedGridScorer* kernel = core::standardFormKernel(prof.size());
+        if (!kernel) {
+            std::cout << core::presetName(preset) << ": bu warp boyutu icin cekirdek yok"
+                      << " (OMR_FIXED_LAYOUT kapali?)\n";
+            continue;
+        }
+
+        cv::Mat page;
+        if (source.empty()) page = syntheticPage(prof.size(), rng);
+        else cv::resize(source, page, prof.size(), 0, 0, cv::INTER_AREA);
+
+        core::DarknessMap map;
+        map.build(page);
+
+        const auto& form = core::kStandardForm.regions;
+        std::vector<cv::Rect> rois;
+        for (const auto& d : form)
+            rois.push_back(core::regionRoi(d.rect, d.grid, d.kind == core::FieldKind::Answers,
+                                           page.cols, page.rows).rect());
+
+        std::vector<std::vector<double>> a, b;
+        double maxDiff = 0.0;
+        for (size_t i = 0; i < form.size(); ++i) {
+            map.scoreGrid(rois[i], form[i].rows, form[i].cols, a);
+            kernel->scoreRegion(i, map, b);
+            for (size_t r = 0; r < a.size(); ++r)
+                for (size_t c = 0; c < a[r].size(); ++c)
+                    maxDiff = std::max(maxDiff, std::abs(a[r][c] - b[r][c]));
+        }
+
+        const double scoreRuntime = msPerIter(iters, [&] {
+            for (size_t i = 0; i < form.size(); ++i) map.scoreGrid(rois[i], form[i].rows, form[i].cols, a);
+        });
+        const double scoreFixed = msPerIter(iters, [&] {
+            for (size_t i = 0; i < form.size(); ++i) kernel->scoreRegion(i, map, b);
+        });
+
+        ROIDetector det;
+        det.setWarpScale(prof.scale);
+        det.setScoringMode(ROIDetector::SCORE_DARKNESS);
+        det.setFixedLayout(false);
+        const double readRuntime = msPerIter(iters, [&] { det.process(page); });
+        det.setFixedLayout(true);
+        const double readFixed = msPerIter(iters, [&] { det.process(page); });
+
+        std::cout << std::left << std::setw(10) << core::presetName(preset) << std::right
+                  << std::setw(4) << prof.width << "x" << std::setw(4) << prof.height << "   "
+                  << std::setw(9) << scoreRuntime << " / " << std::setw(9) << scoreFixed
+                  << " / " << std::setprecision(2) << std::setw(5) << scoreRuntime / scoreFixed
+                  << std::setprecision(4) << "     "
+                  << std::setw(9) << readRuntime << " / " << std::setw(9) << readFixed
+                  << " / " << std::setprecision(2) << std::setw(5) << readRuntime / readFixed
+                  << std::setprecision(4) << "   " << std::scientific << std::setprecision(1) << maxDiff
+                  << std::fixed << std::setprecision(4) << "\n";
+    }
+
+    // Kaskad doğrulaması: yarım çözünürlükte bant dışı kalan satırlar tam çözünürlükte
+    // tekrar ölçülmez; hafif işaret / silinti bu satırlarda yanlış okunabilir. Kaskad ancak
+    // gerçek taramalarda fark sıfırsa açılmalıdır (canlı modda --cascade).
+    std::cout << "\npreset    warp        kaskad: goruntu  farkli karakter  tekrar olculen satir   okuma ms (tek / kaskad)\n";
+    int totalDiff = 0;
+    for (auto preset : {core::SpeedPreset::Fast, core::SpeedPreset::Balanced, core::SpeedPreset::Accurate}) {
+        const core::WarpProfile prof = core::makeWarpProfile(probe.minCellPitch(), preset);
+
+        std::vector<cv::Mat> pages;
+        if (sources.empty()) pages.push_back(syntheticPage(prof.size(), rng));
+        for (const auto& src : sources) {
+            cv::Mat page;
+            cv::resize(src, page, prof.size(), 0, 0, cv::INTER_AREA);
+            pages.push_back(page);
+        }
+
+        ROIDetector single, cascade;
+        for (ROIDetector* d : {&single, &cascade}) {
+            d->setWarpScale(prof.scale);
+            d->setScoringMode(ROIDetector::SCORE_THRESHOLD);
+        }
+        single.setCascade(false);
+        cascade.setCascade(true);
+
+        int diff = 0;
+        double singleMs = 0.0, cascadeMs = 0.0;
+        const int readIters = std::max(1, iters / 20);
+        for (const auto& page : pages) {
+            diff += countDisagreements(single.process(page), cascade.process(page));
+            singleMs += msPerIter(readIters, [&] { single.process(page); });
+            cascadeMs += msPerIter(readIters, [&] { cascade.process(page); });
+        }
+        totalDiff += diff;
+
+        const auto& cs = cascade.cascadeStats();
+        std::cout << std::left << std::setw(10) << core::presetName(preset) << std::right
+                  << std::setw(4) << prof.width << "x" << std::setw(4) << prof.height << "   "
+                  << std::setw(14) << pages.size() << "  " << std::setw(15) << diff << "  "
+                  << std::setw(8) << cs.refined << "/" << std::setw(6) << cs.rows << "        "
+                  << std::setw(9) << singleMs / pages.size() << " / " << std::setw(9) << cascadeMs / pages.size()
+                  << "\n";
+    }
+    if (totalDiff > 0)
+        std::cout << "UYARI: kaskad tek gecisle " << totalDiff << " karakterde farkli okudu\n";
+    return totalDiff > 0 ? 2 : 0;
+}
@@ -0,0 +1,233 @@
+#include "omr/omr_c.h"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "core/SheetGrader.hpp"
+#include "core/TemplateConfig.hpp"
+#include "core/WarpProfile.hpp"
+
+using namespace core;
+
+struct omr_session {
+    AnswerKey key;
+    FormTemplate tmpl;
+    bool customTemplate = false;
+    WarpProfile profile;
+    omr_options opt;
+
+    // Boşta bekleyen okuma bağlamları; eşzamanlı çağrı sayısı kadar büyür, sonra sabit kalır
+    std::mutex mtx;
+    std::vector<std::unique_ptr<SheetGrader>> idle;
+};
+
+namespace {
+
+void writeErr(char* err, size_t cap, const std::string& msg) {
+    if (!err || cap == 0) return;
+    size_t n = std::min(cap - 1, msg.size());
+    std::memcpy(err, msg.data(), n);
+    err[n] = '\0';
+}
+
+void copyField(char (&dst)[32], const std::string& src) {
+    size_t n = std::min(sizeof(dst) - 1, src.size());
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+SpeedPreset toPreset(int p) {
+    switch (p) {
+        case OMR_PRESET_FAST: return SpeedPreset::Fast;
+        case OMR_PRESET_ACCURATE: return SpeedPreset::Accurate;
+        default: return SpeedPreset::Balanced;
+    }
+}
+
+std::unique_ptr<SheetGrader> makeGrader(const omr_session& s) {
+    auto g = std::make_unique<SheetGrader>(s.key, s.profile, s.opt.fill_threshold);
+    if (s.customTemplate) g->setTemplate(s.tmpl.regions, s.tmpl.subjects);
+    if (s.opt.scoring == OMR_SCORING_DARKNESS) g->setScoringMode(ROIDetector::SCORE_DARKNESS);
+    return g;
+}
+
+// Havuzdan bağlam alır, kapsam sonunda geri bırakır
+class GraderLease {
+public:
+    explicit GraderLease(omr_session& s) : s_(s) {
+        {
+            std::lock_guard<std::mutex> lk(s_.mtx);
+            if (!s_.idle.empty()) {
+                g_ = std::move(s_.idle.back());
+                s_.idle.pop_back();
+            }
+        }
+        if (!g_) g_ = makeGrader(s_);
+    }
+    ~GraderLease() {
+        std::lock_guard<std::mutex> lk(s_.mtx);
+        s_.idle.push_back(std::move(g_));
+    }
+    SheetGrader* operator->() { return g_.get(); }
+
+private:
+    omr_session& s_;
+    std::unique_ptr<SheetGrader> g_;
+};
+
+}
+
+extern "C" {
+
+int omr_api_version(void) { return OMR_API_VERSION; }
+
+const char* omr_status_string(omr_status status) {
+    switch (status) {
+        case OMR_OK: return "ok";
+        case OMR_ERR_INVALID_ARG: return "gecersiz arguman";
+        case OMR_ERR_TEMPLATE: return "gecersiz sablon";
+        case OMR_ERR_KEY: return "gecersiz cevap anahtari";
+        case OMR_ERR_NO_PAPER: return "kagit bulunamadi";
+        case OMR_ERR_BUFFER_TOO_SMALL: return "tampon yetersiz";
+        case OMR_ERR_INTERNAL: return "ic hata";
+    }
+    return "bilinmeyen durum";
+}
+
+void omr_options_init(omr_options* opt) {
+    if (!opt) return;
+    opt->preset = OMR_PRESET_BALANCED;
+    opt->scoring = OMR_SCORING_THRESHOLD;
+    opt->fill_threshold = 0.40;
+}
+
+omr_status omr_session_create(const char* template_json, const char* key_json,
+                              const omr_options* opt, omr_session** out,
+                              char* err, size_t err_cap) {
+    if (!out || !key_json) {
+        writeErr(err, err_cap, "out ve key_json zorunlu");
+        return OMR_ERR_INVALID_ARG;
+    }
+    *out = nullptr;
+
+    try {
+        auto s = std::make_unique<omr_session>();
+        if (opt) s->opt = *opt;
+        else omr_options_init(&s->opt);
+
+        std::string msg;
+        if (template_json) {
+            if (!parseTemplateJson(template_json, s->tmpl, msg)) {
+                writeErr(err, err_cap, msg);
+                return OMR_ERR_TEMPLATE;
+            }
+            s->customTemplate = true;
+        }
+
+        std::vector<AnswerKey::QuestionAnswer> answers;
+        if (!parseAnswerKeyJson(key_json, answers, msg)) {
+            writeErr(err, err_cap, msg);
+            return OMR_ERR_KEY;
+        }
+        s->key.loadAnswerKey(answers);
+
+        // Warp boyutu şablonun en küçük hücresinden bir kez türetilir
+        ROIDetector probe;
+        if (s->customTemplate) probe.setTemplate(s->tmpl.regions, s->tmpl.subjects);
+        s->profile = makeWarpProfile(probe.minCellPitch(), toPreset(s->opt.preset));
+
+        s->idle.push_back(makeGrader(*s));
+        *out = s.release();
+        return OMR_OK;
+    } catch (const std::exception& e) {
+        writeErr(err, err_cap, e.what());
+    } catch (...) {
+        writeErr(err, err_cap, "bilinmeyen hata");
+    }
+    return OMR_ERR_INTERNAL;
+}
+
+void omr_session_destroy(omr_session* session) {
+    delete session;
+}
+
+void omr_session_warp_size(const omr_session* session, int* width, int* height) {
+    if (!session) return;
+    if (width) *width = session->profile.width;
+    if (height) *height = session->profile.height;
+}
+
+omr_status omr_grade_gray(omr_session* session,
+                          const uint8_t* gray, int width, int height, size_t stride,
+                          omr_result* out,
+                          char* answers_json, size_t json_cap, size_t* json_len) {
+    if (!session || !gray || !out || width <= 0 || height <= 0 || stride < static_cast<size_t>(width))
+        return OMR_ERR_INVALID_ARG;
+
+    std::memset(out, 0, sizeof(*out));
+    if (json_len) *json_len = 0;
+
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+
+        // Çağıranın tamponu üzerine başlık (kopya yok, salt okunur kullanılır)
+        const cv::Mat img(height, width, CV_8UC1, const_cast<uint8_t*>(gray), stride);
+
+        GraderLease grader(*session);
+
+        cv::Mat warped;
+        if (!grader->warp(img, warped)) {
+            out->elapsed_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - t0).count();
+            return OMR_ERR_NO_PAPER;
+        }
+
+        auto answers = grader->readAll(warped);
+        auto sc = grader->score(answers);
+
+        out->paper_found = 1;
+        out->total_questions = sc.totalQuestions;
+        out->total_correct = sc.totalCorrect;
+        out->total_wrong = sc.totalWrong;
+        out->total_empty = sc.totalEmpty;
+        out->total_score = sc.totalScore;
+        auto tc = answers.find("tc_kimlik");
+        auto no = answers.find("ogrenci_no");
+        if (tc != answers.end()) copyField(out->tc_kimlik, tc->second);
+        if (no != answers.end()) copyField(out->ogrenci_no, no->second);
+        out->elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        if (!answers_json && !json_len) return OMR_OK;
+
+        nlohmann::json j;
+        j["answers"] = answers;
+        for (const auto& kv : sc.subjectDetails) {
+            j["subjects"][kv.first] = {
+                {"correct", kv.second.correct},
+                {"wrong", kv.second.wrong},
+                {"empty", kv.second.empty},
+                {"net", kv.second.net}
+            };
+        }
+        const std::string s = j.dump();
+
+        if (json_len) *json_len = s.size() + 1;
+        if (!answers_json) return OMR_OK;
+        if (json_cap < s.size() + 1) return OMR_ERR_BUFFER_TOO_SMALL;
+
+        std::memcpy(answers_json, s.c_str(), s.size() + 1);
+        return OMR_OK;
+    } catch (...) {
+        return OMR_ERR_INTERNAL;
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+#include "core/AutoCapture.hpp"
+
+namespace core {
+
+void AutoCapture::setEnabled(bool on) {
+    enabled_ = on;
+    state_ = State::Armed;
+    absentFrames_ = 0;
+    capturedKey_.clear();
+}
+
+const char* AutoCapture::stateText() const {
+    if (!enabled_) return "KAPALI";
+    return (state_ == State::Armed) ? "HAZIR" : "KAGIDI KALDIRIN";
+}
+
+AutoCapture::Event AutoCapture::capture(const std::string& identityKey) {
+    state_ = State::Holding;
+    absentFrames_ = 0;
+    capturedKey_ = identityKey;
+    lastCapturedKey_ = identityKey;
+    absenceSeen_ = false;
+    ++captures_;
+    return Event::Capture;
+}
+
+AutoCapture::Event AutoCapture::update(Presence presence, bool ready, const std::string& identityKey) {
+    if (!enabled_) return Event::None;
+
+    // Ölçülmemiş kare: ne kağıt var ne yok sayılır
+    if (presence == Presence::Unknown) return Event::None;
+
+    if (presence == Presence::Absent) {
+        if (++absentFrames_ < params_.removalFrames) return Event::None;
+        absentFrames_ = 0;
+        absenceSeen_ = true;
+        if (state_ == State::Armed) return Event::None;
+        state_ = State::Armed;
+        capturedKey_.clear();
+        return Event::Rearm;
+    }
+    absentFrames_ = 0;
+
+    if (state_ == State::Armed) {
+        // Aynı kağıt kalkmadan tekrar yakalanmaz
+        const bool sameSheet = !absenceSeen_ && !identityKey.empty() && identityKey == lastCapturedKey_;
+        if (ready && !sameSheet) return capture(identityKey);
+        return Event::None;
+    }
+
+    // Holding: kağıt hızlıca değiştirildi (hiç boş kare görülmedi), kimlik farklıysa yeni kağıttır
+    if (ready && !identityKey.empty() && !capturedKey_.empty() && identityKey != capturedKey_) {
+        return capture(identityKey);
+    }
+    return Event::None;
+}
+
+}
@@ -0,0 +1,222 @@
+#include "core/BatchRunner.hpp"
+#include "core/ImagePrefetcher.hpp"
+#include "core/SheetGrader.hpp"
+#include "nlohmann/json.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace core {
+
+namespace {
+
+bool isImageFile(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" ||
+           ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+
+} // namespace
+
+const char* statusName(BatchItem::Status s) {
+    switch (s) {
+        case BatchItem::Status::Ok:          return "ok";
+        case BatchItem::Status::Rescan:      return "rescan";
+        case BatchItem::Status::DuplicateId: return "duplicate_id";
+        case BatchItem::Status::NoPaper:     return "no_paper";
+        case BatchItem::Status::ReadError:   return "read_error";
+    }
+    return "unknown";
+}
+
+std::vector<std::string> collectImagePaths(const std::vector<std::string>& inputs) {
+    std::vector<std::string> out;
+    for (const auto& in : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(in, ec)) {
+            std::vector<std::string> dirFiles;
+            for (const auto& e : fs::directory_iterator(in, ec)) {
+                if (e.is_regular_file() && isImageFile(e.path())) dirFiles.push_back(e.path().string());
+            }
+            std::sort(dirFiles.begin(), dirFiles.end());
+            out.insert(out.end(), dirFiles.begin(), dirFiles.end());
+        } else {
+            out.push_back(in);
+        }
+    }
+    return out;
+}
+
+std::string toJsonLine(const BatchItem& item) {
+    nlohmann::json j;
+    j["file"] = item.path;
+    j["status"] = statusName(item.status);
+    if (!item.duplicateOf.empty()) j["duplicate_of"] = item.duplicateOf;
+    j["ms"] = item.elapsedMs;
+    j["read_ms"] = item.readMs;
+    j["decode_ms"] = item.decodeMs;
+
+    if (item.outcome.ok) {
+        j["answers"] = item.outcome.answers;
+
+        const auto& sc = item.outcome.score;
+        nlohmann::json score;
+        score["total"] = sc.totalScore;
+        score["correct"] = sc.totalCorrect;
+        score["wrong"] = sc.totalWrong;
+        score["empty"] = sc.totalEmpty;
+        for (const auto& kv : sc.subjectDetails) {
+            score["subjects"][kv.first] = {
+                {"correct", kv.second.correct},
+                {"wrong", kv.second.wrong},
+                {"empty", kv.second.empty},
+                {"net", kv.second.net}
+            };
+        }
+        j["score"] = score;
+    }
+    return j.dump();
+}
+
+BatchRunner::BatchRunner(const AnswerKey& key, const BatchOptions& opt)
+    : key_(key), opt_(opt),
+      profile_(makeWarpProfile(ROIDetector().minCellPitch(), opt.preset)) {}
+
+std::vector<BatchItem> BatchRunner::run(const std::vector<std::string>& paths) {
+    auto wall0 = std::chrono::steady_clock::now();
+    std::vector<BatchItem> items(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) items[i].path = paths[i];
+
+    SheetIndex index;
+    stats_ = BatchStats();
+
+    // Kağıtlar arası paralellik: worker + decode çekirdekleri doldurur, OpenCV'nin kendi
+    // havuzu sadece artan payı alır (çalışma sonunda eski ayar geri yüklenir)
+    ThreadRequest treq;
+    treq.mode = WorkMode::Batch;
+    treq.workers = opt_.workers;
+    treq.decodeThreads = opt_.decodeThreads;
+    treq.jobs = std::max<size_t>(1, paths.size());
+    treq.pin = opt_.pinThreads;
+    const ThreadPlan plan = planThreads(treq);
+    const ScopedThreadPlan threadScope(plan);
+    stats_.threads = plan;
+    const int workers = plan.workers;
+
+    ImagePrefetcher::Options popt;
+    popt.needed = profile_.size();
+    popt.readThreads = opt_.readThreads;
+    popt.decodeThreads = plan.decodeThreads;
+    popt.pinFirstSlot = plan.pin ? workers : -1;   // Worker'lardan sonraki çekirdekler
+    popt.maxPendingFiles = opt_.prefetchDepth;
+    popt.maxReadyImages = opt_.prefetchDepth;
+    popt.useIoUring = opt_.useIoUring;
+    popt.dropout = opt_.dropout;
+
+    ImagePrefetcher prefetcher(paths, popt);
+
+    std::mutex statsMtx;
+
+    auto worker = [&](int slot) {
+        if (plan.pin) pinCurrentThread(slot);
+        SheetGrader grader(key_, profile_, opt_.fillThreshold);
+        if (opt_.darknessScoring) grader.setScoringMode(ROIDetector::SCORE_DARKNESS);
+        grader.setScannerMode(opt_.scannerMode);
+        grader.setDropoutChannel(opt_.dropout);
+        double computeMs = 0.0;
+        int scanAligned = 0;
+
+        ImagePrefetcher::Item img;
+        while (prefetcher.next(img)) {
+            auto t0 = std::chrono::steady_clock::now();
+            BatchItem& item = items[img.index];
+            item.readMs = img.readMs;
+            item.decodeMs = img.decodeMs;
+
+            const cv::Mat& image = img.gray;
+            cv::Mat warped;
+            bool fastPath = false;
+
+            if (image.empty()) {
+                item.status = BatchItem::Status::ReadError;
+            } else if (!grader.warp(image, warped, &fastPath)) {
+                item.status = BatchItem::Status::NoPaper;
+            } else {
+                item.status = BatchItem::Status::Ok;
+                if (fastPath) ++scanAligned;
+                SheetIndex::Claim claim;
+                std::map<std::string, std::string> identity;
+
+                if (opt_.detectDuplicates) {
+                    // Giriş anında ucuz ön okuma: kimlik + parmak izi (tam okumada tekrar çözülmez)
+                    identity = grader.readIdentity(warped);
+                    claim = index.claim(makeIdentityKey(identity), computeFingerprint(warped), item.path);
+                }
+
+                if (claim.kind == SheetIndex::ClaimKind::Rescan) {
+                    // Aynı tarama: tam okuma yapma, orijinalin sonucunu kullan
+                    item.status = BatchItem::Status::Rescan;
+                    item.duplicateOf = claim.originalPath;
+                    item.outcome = claim.original.get();
+                } else {
+                    if (claim.kind == SheetIndex::ClaimKind::DuplicateId) {
+                        item.status = BatchItem::Status::DuplicateId;
+                        item.duplicateOf = claim.originalPath;
+                    }
+
+                    try {
+                        item.outcome.answers = opt_.detectDuplicates ? grader.readAll(warped, identity)
+                                                                     : grader.readAll(warped);
+                        item.outcome.score = grader.score(item.outcome.answers);
+                        item.outcome.ok = true;
+                    } catch (const std::exception& e) {
+                        std::cerr << "Okuma hatasi (" << item.path << "): " << e.what() << "\n";
+                    }
+
+                    // Bekleyen tekrar taramalar kilitlenmesin diye her durumda doldur
+                    if (claim.promise) claim.promise->set_value(item.outcome);
+                }
+            }
+
+            item.elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - t0).count();
+            computeMs += item.elapsedMs;
+
+            // Görüntüyü bir sonraki pop'tan önce bırak (bellek sınırı)
+            img.gray.release();
+        }
+
+        std::lock_guard<std::mutex> lock(statsMtx);
+        stats_.computeMs += computeMs;
+        stats_.scanAligned += scanAligned;
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 0; w < workers; ++w) pool.emplace_back(worker, w);
+    for (auto& t : pool) t.join();
+
+    auto ps = prefetcher.stats();
+    stats_.ioWaitMs = ps.ioWaitMs;
+    stats_.decodeMs = ps.decodeMs;
+    stats_.workerStarvedMs = ps.consumerWaitMs;
+    stats_.bytesRead = ps.bytesRead;
+    stats_.usedIoUring = ps.usedIoUring;
+    stats_.wallMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - wall0).count();
+
+    return items;
+}
+
+}
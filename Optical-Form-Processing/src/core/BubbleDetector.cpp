@@ -1,4 +1,5 @@
 #include "core/BubbleDetector.hpp"
+#include "core/WarpProfile.hpp"
 #include <algorithm>
 #include <iostream>
 #include <numeric>
@@ -28,70 +29,255 @@ cv::Rect BubbleDetector::refineBubbleRect(const cv::Mat& cellPatch, const cv::Re
     return initialRect;
 }
 
+BubbleResult BubbleDetector::rowResult(const std::vector<double>& ratios,
+                                       int questionNumber,
+                                       char firstLabel) const {
+    double bestVal = 0.0;
+    double secondVal = 0.0;
+    int bestIdx = -1;
+
+    for (int c = 0; c < (int)ratios.size(); ++c) {
+        double ratio = ratios[c];
+        if (ratio > bestVal) {
+            secondVal = bestVal;
+            bestVal = ratio;
+            bestIdx = c;
+        } else if (ratio > secondVal) {
+            secondVal = ratio;
+        }
+    }
+
+    BubbleResult res;
+    res.questionNumber = questionNumber;
+    res.confidence = bestVal * 100.0;
+    res.secondConfidence = secondVal * 100.0;
+
+    if (bestIdx != -1) {
+        res.markedAnswer = std::string(1, firstLabel + bestIdx);
+        res.isValid = true;
+    } else {
+        res.markedAnswer = "-";
+        res.isValid = false;
+    }
+    return res;
+}
+
+char BubbleDetector::rowDecision(const BubbleResult& r) const {
+    // ROIDetector::bubblesToAnswerString ile aynı kurallar
+    if (!r.isValid) return 'X';
+    if (r.confidence < decisionConfidence_) return '-';
+    if (r.secondConfidence > decisionConfidence_) return '-';
+    return r.markedAnswer.empty() ? '-' : r.markedAnswer[0];
+}
+
 std::vector<BubbleResult> BubbleDetector::detectBubblesGridCore(
     const cv::Mat& roiGray,
     int rows,
     int cols,
     int startQuestionNumber,
     char firstLabel,
-    bool applySmoothing,
+    RegionHistory* history,
     std::vector<std::vector<double>>* cellFillRatios)
 {
-    // 1. Thresholding (Adaptive)
-    cv::Mat blurImg, thr;
-    cv::GaussianBlur(roiGray, blurImg, cv::Size(5, 5), 0);
-    cv::adaptiveThreshold(blurImg, thr, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY_INV, 15, 3);
+    std::vector<std::vector<double>> ratios;
 
-    // Gürültü temizliği
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
-    cv::morphologyEx(thr, thr, cv::MORPH_OPEN, kernel);
+    // Hücreler yarım çözünürlükte de ölçülebilecek kadar büyükse kaskad
+    const int minCell = std::min(roiGray.cols / std::max(1, cols), roiGray.rows / std::max(1, rows));
+    if (cascadeEnabled_ && minCell / 2 >= kMinCascadeCellPx) {
+        // 1. Hızlı geçiş: yarım çözünürlük (1/4 piksel)
+        cv::Mat half, halfThr;
+        cv::pyrDown(roiGray, half);
+        binarizeForFill(half, kernelScale_ * 0.5, halfThr);
+        samplingGrid(halfThr.size(), rows, cols).score(halfThr, ratios);
 
-    std::vector<BubbleResult> results;
-    int cellW = roiGray.cols / cols;
-    int cellH = roiGray.rows / rows;
-
-    for (int r = 0; r < rows; ++r) {
-        double bestVal = 0.0;
-        double secondVal = 0.0;
-        int bestIdx = -1;
+        // 2. Sadece belirsiz satırlar tam çözünürlükte yeniden ölçülür
+        for (int r = 0; r < rows; ++r) {
+            cascadeStats_.rows++;
+            if (!isAmbiguousRow(ratios[r])) continue;
+            cascadeStats_.refined++;
+            refineRow(roiGray, rows, cols, r, ratios[r]);
+        }
+    } else {
+        // Tek geçiş: tam çözünürlükte eşik + önceden hesaplanmış eliptik ağırlıklı maskeler
+        // (grid çizgileri ve basılı harf skoru kirletmez)
+        cv::Mat thr;
+        binarizeForFill(roiGray, kernelScale_, thr);
+        samplingGrid(thr.size(), rows, cols).score(thr, ratios);
+    }
 
-        for (int c = 0; c < cols; ++c) {
-            // Kenar payları
-            int marginX = static_cast<int>(cellW * 0.15);
-            int marginY = static_cast<int>(cellH * 0.15);
-            cv::Rect cell(c * cellW + marginX, r * cellH + marginY, cellW - 2*marginX, cellH - 2*marginY);
-            
-            cell &= cv::Rect(0, 0, thr.cols, thr.rows);
-            if (cell.width <= 0 || cell.height <= 0) continue;
+    auto results = resultsFromRatios(ratios, startQuestionNumber, firstLabel, history);
+    if (cellFillRatios) *cellFillRatios = std::move(ratios);
+    return results;
+}
 
-            double ratio = calculateFillRatio(thr(cell));
+std::vector<BubbleResult> BubbleDetector::resultsFromRatios(
+    const std::vector<std::vector<double>>& ratios,
+    int startQuestionNumber,
+    char firstLabel,
+    RegionHistory* history)
+{
+    const int rows = static_cast<int>(ratios.size());
+    const int cols = rows > 0 ? static_cast<int>(ratios[0].size()) : 0;
 
-            if (ratio > bestVal) {
-                secondVal = bestVal;
-                bestVal = ratio;
-                bestIdx = c;
-            } else if (ratio > secondVal) {
-                secondVal = ratio;
-            }
+    // Temporal füzyon: ölçümü bölgenin EMA'sına kat, kararları EMA'dan ver
+    const std::vector<std::vector<double>>* source = &ratios;
+    if (history) {
+        bool fresh = (int)history->ema.size() != rows ||
+                     (rows > 0 && (int)history->ema[0].size() != cols);
+        if (fresh) {
+            history->ema = ratios;
+            history->lastDecision.assign(rows, '\0');
+            history->stableFrames.assign(rows, 0);
+        } else {
+            const double alpha = 2.0 / (historySize_ + 1.0);
+            for (int r = 0; r < rows; ++r)
+                for (int c = 0; c < cols; ++c)
+                    history->ema[r][c] = alpha * ratios[r][c] + (1.0 - alpha) * history->ema[r][c];
         }
+        source = &history->ema;
+    }
 
-        BubbleResult res;
-        res.questionNumber = startQuestionNumber + r;
-        res.confidence = bestVal * 100.0;
-        res.secondConfidence = secondVal * 100.0;
+    std::vector<BubbleResult> results;
+    results.reserve(rows);
+    for (int r = 0; r < rows; ++r) {
+        results.push_back(rowResult((*source)[r], startQuestionNumber + r, firstLabel));
+    }
 
-        if (bestIdx != -1) {
-            res.markedAnswer = std::string(1, firstLabel + bestIdx);
-            res.isValid = true;
-        } else {
-            res.markedAnswer = "-";
-            res.isValid = false;
+    if (history) {
+        bool allStable = true;
+        for (int r = 0; r < rows; ++r) {
+            char d = rowDecision(results[r]);
+            if (d == history->lastDecision[r]) history->stableFrames[r]++;
+            else history->stableFrames[r] = 1;
+            history->lastDecision[r] = d;
+            if (history->stableFrames[r] < historySize_) allStable = false;
         }
-        results.push_back(res);
+        history->fused = results;
+        history->settled = allStable;
     }
+
     return results;
 }
 
+std::vector<BubbleResult> BubbleDetector::detectFromRatios(
+    const std::vector<std::vector<double>>& ratios,
+    const std::string& regionKey,
+    int startQuestionNumber,
+    char firstLabel)
+{
+    if (!temporalSmoothingEnabled_) {
+        return resultsFromRatios(ratios, startQuestionNumber, firstLabel, nullptr);
+    }
+
+    RegionHistory& h = answerHistory_[regionKey];
+    if (h.settled && h.fused.size() == ratios.size()) return h.fused;
+
+    return resultsFromRatios(ratios, startQuestionNumber, firstLabel, &h);
+}
+
+void BubbleDetector::binarizeForFill(const cv::Mat& gray, double scale, cv::Mat& thr) const {
+    cv::Mat blurImg;
+    const int blurK = core::scaledKernel(5, scale);
+    const int morphK = core::scaledKernel(3, scale, false);
+    cv::GaussianBlur(gray, blurImg, cv::Size(blurK, blurK), 0);
+    cv::adaptiveThreshold(blurImg, thr, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY_INV,
+                          core::scaledKernel(15, scale), 3);
+
+    // Gürültü temizliği
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(morphK, morphK));
+    cv::morphologyEx(thr, thr, cv::MORPH_OPEN, kernel);
+}
+
+bool BubbleDetector::isAmbiguousRow(const std::vector<double>& ratios) const {
+    double best = 0.0, second = 0.0;
+    for (double v : ratios) {
+        if (v > best) { second = best; best = v; }
+        else if (v > second) second = v;
+    }
+
+    // Karar eşiğinin (bubblesToAnswerString) iki yanındaki bant dışı sonuçlar kesindir
+    const double t = decisionConfidence_ / 100.0;
+    const bool clearlyBlank = best < t - cascadeBand_;
+    const bool clearlySingle = best > t + cascadeBand_ && second < t - cascadeBand_;
+    const bool clearlyMulti = second > t + cascadeBand_;
+    return !(clearlyBlank || clearlySingle || clearlyMulti);
+}
+
+void BubbleDetector::refineRow(const cv::Mat& roiGray, int rows, int cols, int r,
+                               std::vector<double>& rowRatios) {
+    const core::SamplingGrid& g = samplingGrid(roiGray.size(), rows, cols);
+
+    // Satır şeridi + adaptif eşik penceresi kadar pay (şerit kenarı sonucu değiştirmez)
+    const int pad = core::scaledKernel(15, kernelScale_) + core::scaledKernel(5, kernelScale_);
+    const int top = g.origin(r, 0).y;
+    const int y0 = std::max(0, top - pad);
+    const int y1 = std::min(roiGray.rows, top + g.mask().size().height + pad);
+
+    cv::Mat stripThr;
+    binarizeForFill(roiGray.rowRange(y0, y1), kernelScale_, stripThr);
+
+    for (int c = 0; c < cols; ++c) {
+        rowRatios[c] = g.mask().score(stripThr, g.origin(r, c) - cv::Point(0, y0));
+    }
+}
+
+const core::SamplingGrid& BubbleDetector::samplingGrid(cv::Size roi, int rows, int cols) {
+    for (const auto& g : gridCache_)
+        if (g.matches(roi, rows, cols)) return g;
+
+    // Bölge boyutu warp profiline bağlı; pratikte bölge başına bir kez kurulur
+    gridCache_.emplace_back(roi, rows, cols, maskWeights_);
+    return gridCache_.back();
+}
+
+void BubbleDetector::setMaskWeights(const core::MaskWeights& w) {
+    maskWeights_ = w;
+    gridCache_.clear();
+}
+
+std::vector<BubbleResult> BubbleDetector::detectBubblesFused(
+    const cv::Mat& roiGray,
+    int rows,
+    int cols,
+    const std::string& regionKey,
+    int startQuestionNumber,
+    char firstLabel,
+    std::vector<std::vector<double>>* cellFillRatios)
+{
+    if (!temporalSmoothingEnabled_) {
+        return detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, nullptr, cellFillRatios);
+    }
+
+    RegionHistory& h = answerHistory_[regionKey];
+    if (h.settled && (int)h.fused.size() == rows) return h.fused;
+
+    return detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, &h, cellFillRatios);
+}
+
+bool BubbleDetector::isRegionSettled(const std::string& regionKey) const {
+    if (!temporalSmoothingEnabled_) return false;
+    auto it = answerHistory_.find(regionKey);
+    return it != answerHistory_.end() && it->second.settled;
+}
+
+const std::vector<BubbleResult>& BubbleDetector::settledResults(const std::string& regionKey) const {
+    static const std::vector<BubbleResult> empty;
+    auto it = answerHistory_.find(regionKey);
+    return it != answerHistory_.end() ? it->second.fused : empty;
+}
+
+const std::vector<std::vector<double>>& BubbleDetector::settledRatios(const std::string& regionKey) const {
+    static const std::vector<std::vector<double>> empty;
+    auto it = answerHistory_.find(regionKey);
+    return it != answerHistory_.end() ? it->second.ema : empty;
+}
+
+void BubbleDetector::setTemporalSmoothing(bool enabled, int historySize) {
+    temporalSmoothingEnabled_ = enabled;
+    historySize_ = std::max(1, historySize);
+    answerHistory_.clear();
+}
+
 std::vector<BubbleResult> BubbleDetector::detectBubbles(
     const cv::Mat& roiGray,
     int rows,
@@ -99,7 +285,7 @@ std::vector<BubbleResult> BubbleDetector::detectBubbles(
     int startQuestionNumber,
     char firstLabel)
 {
-    return detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, false, nullptr);
+    return detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, nullptr, nullptr);
 }
 
 std::vector<BubbleResult> BubbleDetector::detectBubblesWithContours(
@@ -111,7 +297,7 @@ std::vector<BubbleResult> BubbleDetector::detectBubblesWithContours(
     cv::Mat* debugVis)
 {
     // Grid Core fonksiyonunu çağırıyoruz
-    auto results = detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, false, nullptr);
+    auto results = detectBubblesGridCore(roiGray, rows, cols, startQuestionNumber, firstLabel, nullptr, nullptr);
 
     if (debugVis) {
         if (debugVis->empty() || debugVis->size() != roiGray.size()) {
@@ -194,18 +380,20 @@ std::vector<BubbleResult> BubbleDetector::detectBubblesByColumn(
 {
     // 1. Görüntü Ön İşleme (Adaptive Threshold)
     cv::Mat blurImg, thr;
-    cv::GaussianBlur(roiGray, blurImg, cv::Size(5, 5), 0);
+    const int blurK = core::scaledKernel(5, kernelScale_);
+    const int morphK = core::scaledKernel(3, kernelScale_, false);
+    cv::GaussianBlur(roiGray, blurImg, cv::Size(blurK, blurK), 0);
     
     // ID alanları genelde daha koyu/kalın işaretlenir, o yüzden parametreleri sabit tutuyoruz
     cv::adaptiveThreshold(
         blurImg, thr, 255,
         cv::ADAPTIVE_THRESH_GAUSSIAN_C,
         cv::THRESH_BINARY_INV,
-        21, 5
+        core::scaledKernel(21, kernelScale_), 5
     );
 
     // Gürültü temizliği
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(morphK, morphK));
     cv::morphologyEx(thr, thr, cv::MORPH_OPEN, kernel);
 
     std::vector<BubbleResult> results;
@@ -0,0 +1,105 @@
+#include "core/BubbleMask.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+/* ---------------- BubbleMask ---------------- */
+
+BubbleMask BubbleMask::elliptical(const cv::Size2f& cell, const MaskWeights& w) {
+    BubbleMask m;
+
+    const double ry = std::max(1.0, w.radius * std::min(cell.width, cell.height));
+    const double rx = std::max(1.0, std::min(ry * w.aspect, 0.5 * cell.width));
+    const int W = static_cast<int>(std::ceil(2.0 * rx));
+    const int H = static_cast<int>(std::ceil(2.0 * ry));
+    const double cx = W / 2.0, cy = H / 2.0;
+    m.size_ = cv::Size(W, H);
+
+    const double c2 = w.centerFrac * w.centerFrac;
+    const double o2 = w.outlineFrac * w.outlineFrac;
+
+    for (int y = 0; y < H; ++y) {
+        double ny = (y + 0.5 - cy) / ry;
+        int x0 = -1;
+        for (int x = 0; x <= W; ++x) {
+            double nx = (x + 0.5 - cx) / rx;
+            double d2 = nx * nx + ny * ny;
+            bool inside = (x < W) && d2 <= 1.0;
+
+            if (inside) {
+                if (x0 < 0) {
+                    x0 = x;
+                    m.spans_.push_back({static_cast<int16_t>(y), static_cast<int16_t>(x), 0,
+                                        static_cast<int32_t>(m.weights_.size())});
+                }
+                uint8_t wt = (d2 < c2) ? w.center : (d2 > o2) ? w.outline : w.ring;
+                m.weights_.push_back(wt);
+                m.weightSum_ += wt;
+            } else if (x0 >= 0) {
+                m.spans_.back().len = static_cast<int16_t>(x - x0);
+                x0 = -1;
+            }
+        }
+    }
+    return m;
+}
+
+double BubbleMask::score(const cv::Mat& bin, cv::Point origin) const {
+    if (weightSum_ == 0) return 0.0;
+
+    uint32_t acc = 0;
+    const uint8_t* wBase = weights_.data();
+    for (const Span& s : spans_) {
+        const uint8_t* p = bin.ptr<uint8_t>(origin.y + s.dy) + origin.x + s.x0;
+        const uint8_t* w = wBase + s.wOffset;
+        uint32_t rowAcc = 0;
+        for (int i = 0; i < s.len; ++i) rowAcc += p[i] & w[i];   // 255 & w = w, 0 & w = 0
+        acc += rowAcc;
+    }
+    return static_cast<double>(acc) / weightSum_;
+}
+
+cv::Mat BubbleMask::render() const {
+    cv::Mat img = cv::Mat::zeros(size_, CV_8U);
+    for (const Span& s : spans_) {
+        uint8_t* row = img.ptr<uint8_t>(s.dy) + s.x0;
+        std::copy(weights_.begin() + s.wOffset, weights_.begin() + s.wOffset + s.len, row);
+    }
+    return img;
+}
+
+/* ---------------- SamplingGrid ---------------- */
+
+SamplingGrid::SamplingGrid(cv::Size roi, int rows, int cols, const MaskWeights& w)
+    : roi_(roi), rows_(rows), cols_(cols) {
+    if (rows <= 0 || cols <= 0 || roi.width <= 0 || roi.height <= 0) return;
+
+    const cv::Size2f cell(static_cast<float>(roi.width) / cols, static_cast<float>(roi.height) / rows);
+    mask_ = BubbleMask::elliptical(cell, w);
+    const cv::Size ms = mask_.size();
+
+    origins_.reserve(static_cast<size_t>(rows) * cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int x = static_cast<int>(std::lround((c + 0.5) * cell.width - ms.width / 2.0));
+            int y = static_cast<int>(std::lround((r + 0.5) * cell.height - ms.height / 2.0));
+            // Maske her zaman ROI içinde kalır (score sınır kontrolü yapmaz)
+            x = std::clamp(x, 0, std::max(0, roi.width - ms.width));
+            y = std::clamp(y, 0, std::max(0, roi.height - ms.height));
+            origins_.emplace_back(x, y);
+        }
+    }
+}
+
+void SamplingGrid::score(const cv::Mat& bin, std::vector<std::vector<double>>& ratios) const {
+    ratios.assign(rows_, std::vector<double>(cols_, 0.0));
+    if (bin.size() != roi_ || origins_.empty()) return;
+    if (mask_.size().width > roi_.width || mask_.size().height > roi_.height) return;
+
+    for (int r = 0; r < rows_; ++r)
+        for (int c = 0; c < cols_; ++c)
+            ratios[r][c] = mask_.score(bin, origins_[r * cols_ + c]);
+}
+
+}
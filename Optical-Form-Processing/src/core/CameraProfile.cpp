@@ -0,0 +1,150 @@
+#include "core/CameraProfile.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace core {
+
+namespace {
+
+// Ters bozulma çözümünde yineleme sayısı (cv::undistortPoints varsayılanı ile aynı mertebe)
+constexpr int kUndistortIterations = 20;
+
+} // namespace
+
+CameraProfile CameraProfile::adjusted(cv::Size frameSize, cv::Point origin) const {
+    CameraProfile c = *this;
+    if (imageSize.width > 0 && imageSize.height > 0 && frameSize != imageSize) {
+        const double sx = static_cast<double>(frameSize.width) / imageSize.width;
+        const double sy = static_cast<double>(frameSize.height) / imageSize.height;
+        c.fx *= sx; c.cx *= sx;
+        c.fy *= sy; c.cy *= sy;
+    }
+    c.imageSize = frameSize;
+    c.cx -= origin.x;
+    c.cy -= origin.y;
+    return c;
+}
+
+cv::Point2d CameraProfile::distort(cv::Point2d ideal) const {
+    const double x = (ideal.x - cx) / fx;
+    const double y = (ideal.y - cy) / fy;
+    const double r2 = x * x + y * y, r4 = r2 * r2, r6 = r4 * r2;
+
+    const double radial = (1.0 + k[0] * r2 + k[1] * r4 + k[4] * r6) /
+                          (1.0 + k[5] * r2 + k[6] * r4 + k[7] * r6);
+    const double xd = x * radial + 2.0 * k[2] * x * y + k[3] * (r2 + 2.0 * x * x);
+    const double yd = y * radial + k[2] * (r2 + 2.0 * y * y) + 2.0 * k[3] * x * y;
+    return cv::Point2d(fx * xd + cx, fy * yd + cy);
+}
+
+cv::Point2d CameraProfile::undistort(cv::Point2d observed) const {
+    const double x0 = (observed.x - cx) / fx;
+    const double y0 = (observed.y - cy) / fy;
+    double x = x0, y = y0;
+
+    for (int i = 0; i < kUndistortIterations; ++i) {
+        const double r2 = x * x + y * y, r4 = r2 * r2, r6 = r4 * r2;
+        const double icdist = (1.0 + k[5] * r2 + k[6] * r4 + k[7] * r6) /
+                              (1.0 + k[0] * r2 + k[1] * r4 + k[4] * r6);
+        if (icdist < 0.0) { x = x0; y = y0; break; }   // Model bu noktada geçersiz
+        const double dx = 2.0 * k[2] * x * y + k[3] * (r2 + 2.0 * x * x);
+        const double dy = k[2] * (r2 + 2.0 * y * y) + 2.0 * k[3] * x * y;
+        x = (x0 - dx) * icdist;
+        y = (y0 - dy) * icdist;
+    }
+    return cv::Point2d(fx * x + cx, fy * y + cy);
+}
+
+bool loadCameraProfile(const std::string& path, CameraProfile& out, std::string& err) {
+    try {
+        cv::FileStorage fs(path, cv::FileStorage::READ);
+        if (!fs.isOpened()) { err = "Kalibrasyon dosyasi acilamadi: " + path; return false; }
+
+        cv::Mat K, D;
+        fs["camera_matrix"] >> K;
+        fs["distortion_coefficients"] >> D;
+        if (K.rows != 3 || K.cols != 3) { err = "camera_matrix 3x3 olmali"; return false; }
+        if (D.total() != 4 && D.total() != 5 && D.total() != 8) {
+            err = "distortion_coefficients 4, 5 veya 8 eleman olmali";
+            return false;
+        }
+        K.convertTo(K, CV_64F);
+        D = D.reshape(1, 1);
+        D.convertTo(D, CV_64F);
+
+        CameraProfile c;
+        c.fx = K.at<double>(0, 0);
+        c.fy = K.at<double>(1, 1);
+        c.cx = K.at<double>(0, 2);
+        c.cy = K.at<double>(1, 2);
+        for (int i = 0; i < static_cast<int>(D.total()); ++i) c.k[i] = D.at<double>(0, i);
+
+        int w = 0, h = 0;
+        if (!fs["image_width"].empty()) w = static_cast<int>(fs["image_width"]);
+        if (!fs["image_height"].empty()) h = static_cast<int>(fs["image_height"]);
+        c.imageSize = cv::Size(w, h);
+
+        if (c.empty()) { err = "Gecersiz odak uzakligi"; return false; }
+        out = c;
+        return true;
+    } catch (const cv::Exception& e) {
+        err = "Kalibrasyon dosyasi okunamadi: " + std::string(e.what());
+        return false;
+    }
+}
+
+void buildFusedWarpMap(const cv::Mat& idealH, const CameraProfile& cam,
+                       cv::Size warpSize, int step, cv::Mat& map) {
+    CV_Assert(idealH.rows == 3 && idealH.cols == 3 && idealH.type() == CV_64F);
+    const int W = warpSize.width, H = warpSize.height;
+    step = std::max(2, step);
+
+    // Düğümler [0, W-1] x [0, H-1] aralığını eşit adımla kaplar (kenarlarda da tam değer)
+    const int gw = std::max(2, (W - 2) / step + 2);
+    const int gh = std::max(2, (H - 2) / step + 2);
+    const double sx = (W - 1) / static_cast<double>(gw - 1);
+    const double sy = (H - 1) / static_cast<double>(gh - 1);
+
+    // Düğümlerde: warp -> ideal piksel (homografi) -> kameranın gördüğü piksel (bozulma)
+    const double* h = idealH.ptr<double>(0);
+    std::vector<cv::Point2f> nodes(static_cast<size_t>(gw) * gh);
+    for (int j = 0; j < gh; ++j) {
+        const double v = j * sy;
+        for (int i = 0; i < gw; ++i) {
+            const double u = i * sx;
+            const double z = h[6] * u + h[7] * v + h[8];
+            const cv::Point2d ideal((h[0] * u + h[1] * v + h[2]) / z, (h[3] * u + h[4] * v + h[5]) / z);
+            const cv::Point2d d = cam.distort(ideal);
+            nodes[static_cast<size_t>(j) * gw + i] = cv::Point2f(static_cast<float>(d.x), static_cast<float>(d.y));
+        }
+    }
+
+    // Sütun ağırlıkları bir kez
+    std::vector<int> i0(W);
+    std::vector<float> wx(W);
+    for (int x = 0; x < W; ++x) {
+        const double fx = x / sx;
+        i0[x] = std::min(static_cast<int>(fx), gw - 2);
+        wx[x] = static_cast<float>(fx - i0[x]);
+    }
+
+    map.create(warpSize, CV_32FC2);
+    std::vector<cv::Point2f> row(gw);
+    for (int y = 0; y < H; ++y) {
+        const double fy = y / sy;
+        const int j0 = std::min(static_cast<int>(fy), gh - 2);
+        const float wy = static_cast<float>(fy - j0);
+        const cv::Point2f* a = &nodes[static_cast<size_t>(j0) * gw];
+        const cv::Point2f* b = a + gw;
+        for (int i = 0; i < gw; ++i) row[i] = a[i] + (b[i] - a[i]) * wy;
+
+        cv::Point2f* dst = map.ptr<cv::Point2f>(y);
+        for (int x = 0; x < W; ++x) {
+            const cv::Point2f& p = row[i0[x]];
+            const cv::Point2f& q = row[i0[x] + 1];
+            dst[x] = p + (q - p) * wx[x];
+        }
+    }
+}
+
+}
@@ -6,7 +6,83 @@ using namespace cv;
 
 namespace core {
 
-std::vector<Point2f> CornerFinder::orderTLTRBRBL(const std::vector<Point2f>& pts, Point2f C) const {
+namespace {
+
+// Yön imzası için küçültülmüş görüntünün hedef genişliği
+constexpr int kOrientationProbeWidth = 320;
+
+// En iyi yön ikinciden bu kadar (kosinüs benzerliği) iyi değilse varsayılan yön kullanılır
+constexpr double kOrientationMargin = 0.05;
+
+// Köşe işareti alan sınırları (piksel; bileşen piksel sayısı)
+constexpr int kMarkerMinArea = 50;
+constexpr int kMarkerMaxArea = 15000;
+
+// Birleşik bozulma + perspektif tablosunda tam model hesaplanan düğüm aralığı (warp pikseli)
+constexpr int kFusedMapStep = 16;
+
+// Tarayıcı hızlı yolu (processScan)
+constexpr int kScanProbeWidth = 480;          // İşaretlerin arandığı küçük kopyanın genişliği
+constexpr double kScanCornerWindow = 0.30;    // Her köşede aranan alan (görüntü kenarının oranı)
+constexpr int kScanMarkerMinArea = 9;         // Küçük kopyada en küçük işaret (piksel)
+constexpr double kScanMaxAngleDeg = 8.0;      // Daha dönük kağıt tarayıcı girişi sayılmaz
+constexpr double kScanMaxResidual = 0.003;    // Benzerlik uyumu hatası sınırı (warp köşegeni oranı)
+constexpr double kScanIntegerTol = 0.25;      // Dönüşüm bu kadar (piksel) içinde kaydırmaysa kırpılır
+
+} // namespace
+
+void CornerFinder::setLayoutSignature(const Mat& signature) {
+    if (signature.empty()) { layoutSig_.release(); return; }
+
+    Mat s;
+    signature.convertTo(s, CV_32F);
+    s -= mean(s);
+    double n = norm(s);
+    layoutSig_ = (n > 0) ? Mat(s / n) : Mat();
+}
+
+int CornerFinder::detectQuarterTurns(const Mat& gray, const std::vector<Point2f>& imageOrder) const {
+    if (layoutSig_.empty() || imageOrder.size() != 4) return 0;
+
+    // Kağıt yatay görünüyorsa yalnızca 90/270, dikeyse 0/180 adayı kalır
+    auto len = [](Point2f a, Point2f b) { return std::hypot(a.x - b.x, a.y - b.y); };
+    double top = len(imageOrder[0], imageOrder[1]) + len(imageOrder[3], imageOrder[2]);
+    double side = len(imageOrder[0], imageOrder[3]) + len(imageOrder[1], imageOrder[2]);
+    const bool sheetPortrait = outH_ >= outW_;
+    const int first = ((top > side) == sheetPortrait) ? 1 : 0;
+
+    // Tam kare üzerinde değil, küçültülmüş kopyada örneklenir
+    double scale = std::min(1.0, static_cast<double>(kOrientationProbeWidth) / gray.cols);
+    Mat small;
+    resize(gray, small, Size(), scale, scale, INTER_AREA);
+
+    const Size sz = layoutSig_.size();
+    std::vector<Point2f> dst = {
+        {0, 0}, {(float)sz.width - 1, 0},
+        {(float)sz.width - 1, (float)sz.height - 1}, {0, (float)sz.height - 1}
+    };
+
+    double best = -2.0, second = -2.0;
+    int bestK = first;
+    for (int k = first; k < 4; k += 2) {
+        std::vector<Point2f> src(4);
+        for (int i = 0; i < 4; ++i) src[i] = imageOrder[(i + k) % 4] * static_cast<float>(scale);
+
+        Mat thumb, ink;
+        warpPerspective(small, thumb, getPerspectiveTransform(src, dst), sz, INTER_LINEAR, BORDER_REPLICATE);
+        thumb.convertTo(ink, CV_32F, -1.0, 255.0);   // Mürekkep = yüksek değer
+        ink -= mean(ink);
+        double n = norm(ink);
+        double score = (n > 0) ? ink.dot(layoutSig_) / n : 0.0;
+
+        if (score > best) { second = best; best = score; bestK = k; }
+        else if (score > second) second = score;
+    }
+
+    return (best - second >= kOrientationMargin) ? bestK : first;
+}
+
+std::vector<Point2f> CornerFinder::orderTLTRBRBL(const std::vector<Point2f>& pts, Point2f C, int quarterTurns) const {
     if (pts.size() != 4) {
         return pts;
     }
@@ -28,7 +104,12 @@ std::vector<Point2f> CornerFinder::orderTLTRBRBL(const std::vector<Point2f>& pts
     Point2f topRight = remaining[0];
     Point2f bottomLeft = remaining[1];
     
-    return {topLeft, topRight, bottomRight, bottomLeft};
+    std::vector<Point2f> imageOrder = {topLeft, topRight, bottomRight, bottomLeft};
+
+    // Dönüklük köşe sırasına katlanır: homografi doğrudan düz formu üretir, kare döndürülmez
+    std::vector<Point2f> out(4);
+    for (int i = 0; i < 4; ++i) out[i] = imageOrder[(i + quarterTurns) % 4];
+    return out;
 }
 
 bool CornerFinder::findCornerSquares(const Mat& gray, std::vector<Point2f>& corners, Mat* dbg) const {
@@ -43,57 +124,76 @@ bool CornerFinder::findCornerSquares(const Mat& gray, std::vector<Point2f>& corn
     
     if (dbg) cvtColor(gray, *dbg, COLOR_GRAY2BGR);
     
-    std::vector<std::vector<Point>> contours;
-    findContours(th, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-    
-    std::vector<std::vector<Point>> candidateContours;
-    
-    for (auto& c : contours) {
-        double area = contourArea(c);
-        if (area < 50 || area > 15000) continue;
-        
-        Rect br = boundingRect(c);
+    // Bağlı bileşenler: alan / sınır kutusu / ağırlık merkezi tek geçişte gelir.
+    // Kontur ve dış bükey zarf sadece istatistik filtresinden geçen birkaç aday için
+    // çıkarılır; dağınık arka planda (binlerce leke) maliyet sabit kalır.
+    Mat labels, stats, centroids;
+    const int n = connectedComponentsWithStats(th, labels, stats, centroids, 8, CV_32S);
+
+    struct Candidate {
+        int area;
+        Point2f center;
+        std::vector<Point> contour;
+    };
+    std::vector<Candidate> candidates;
+
+    for (int i = 1; i < n; ++i) {
+        const int* st = stats.ptr<int>(i);
+        const int area = st[CC_STAT_AREA];
+        if (area < kMarkerMinArea || area > kMarkerMaxArea) continue;
+
+        const Rect br(st[CC_STAT_LEFT], st[CC_STAT_TOP], st[CC_STAT_WIDTH], st[CC_STAT_HEIGHT]);
         float ar = (float)br.width / br.height;
         if (ar < 0.7f || ar > 1.4f) continue;
-        
-        double extent = area / br.area();
+
+        double extent = static_cast<double>(area) / br.area();
         if (extent < 0.65) continue;
-        
+
+        // Hayatta kalan aday: sadece kendi sınır kutusunda kontur + zarf
+        Mat mask = (labels(br) == i);
+        std::vector<std::vector<Point>> cs;
+        findContours(mask, cs, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE, br.tl());
+        if (cs.empty()) continue;
+        const std::vector<Point>& c = *std::max_element(cs.begin(), cs.end(),
+            [](const std::vector<Point>& a, const std::vector<Point>& b) { return a.size() < b.size(); });
+
         std::vector<Point> hull;
         convexHull(c, hull);
         double hullArea = contourArea(hull);
-        double solidity = area / hullArea;
+        double solidity = hullArea > 0 ? contourArea(c) / hullArea : 0.0;
         if (solidity < 0.8) continue;
-        
-        candidateContours.push_back(c);
+
+        const double* ct = centroids.ptr<double>(i);
+        candidates.push_back({area, Point2f(static_cast<float>(ct[0]), static_cast<float>(ct[1])), c});
     }
     
-    if (dbg) drawContours(*dbg, candidateContours, -1, Scalar(0,255,255), 2);
+    if (dbg) {
+        std::vector<std::vector<Point>> cs;
+        for (const auto& c : candidates) cs.push_back(c.contour);
+        drawContours(*dbg, cs, -1, Scalar(0,255,255), 2);
+    }
     
-    if (candidateContours.size() < 4) {
+    if (candidates.size() < 4) {
         if (dbg) {
-            std::string msg = "Yeterli aday yok: " + std::to_string(candidateContours.size()) + "/4";
+            std::string msg = "Yeterli aday yok: " + std::to_string(candidates.size()) + "/4";
             putText(*dbg, msg, {20,40}, FONT_HERSHEY_SIMPLEX, 0.8, {0,0,255}, 2);
         }
         return false;
     }
     
-    std::sort(candidateContours.begin(), candidateContours.end(), [](auto& a, auto& b) {
-        return contourArea(a) > contourArea(b);
-    });
-    
-    std::vector<std::vector<Point>> finalFour(candidateContours.begin(), 
-                                               candidateContours.begin() + std::min((size_t)4, candidateContours.size()));
+    // En büyük dört aday (alan bileşen istatistiğinden, karşılaştırmada yeniden hesaplanmaz)
+    std::partial_sort(candidates.begin(), candidates.begin() + 4, candidates.end(),
+                      [](const Candidate& a, const Candidate& b) { return a.area > b.area; });
+    candidates.resize(4);
     
-    if (dbg) drawContours(*dbg, finalFour, -1, Scalar(0,255,0), 3);
+    if (dbg) {
+        std::vector<std::vector<Point>> cs;
+        for (const auto& c : candidates) cs.push_back(c.contour);
+        drawContours(*dbg, cs, -1, Scalar(0,255,0), 3);
+    }
     
     std::vector<Point2f> centers;
-    for (auto& c : finalFour) {
-        Moments m = moments(c);
-        if (m.m00 != 0) {
-            centers.push_back(Point2f(m.m10 / m.m00, m.m01 / m.m00));
-        }
-    }
+    for (const auto& c : candidates) centers.push_back(c.center);
     
     if (centers.size() != 4) {
         if (dbg) putText(*dbg, "Merkez hesaplama hatasi", {20,70}, FONT_HERSHEY_SIMPLEX, 0.8, {0,0,255}, 2);
@@ -125,20 +225,35 @@ bool CornerFinder::findCornerSquares(const Mat& gray, std::vector<Point2f>& corn
     return true;
 }
 
-CornerResult CornerFinder::processFrame(const Mat& bgr, bool debug_on) const {
+CornerResult CornerFinder::processFrame(const Mat& bgr, bool debug_on, const CameraProfile* cam) const {
     CornerResult R;
     if (bgr.empty()) return R;
     
+    // Batch girişleri zaten tek kanal açılır (ImageLoader); tekrar dönüştürme.
+    // Dropout modunda gri yerine formun kaybolduğu kanal alınır.
     Mat gray;
-    cvtColor(bgr, gray, COLOR_BGR2GRAY);
+    toSheetGray(bgr, dropout_, gray);
     
     std::vector<Point2f> srcPoints;
     Mat dbgImg;
     R.paper_ok = findCornerSquares(gray, srcPoints, debug_on ? &dbgImg : nullptr);
     
-    if (debug_on) R.debug_bgr = dbgImg;
-    
-    if (!R.paper_ok) return R;
+    if (!R.paper_ok) {
+        if (debug_on) R.debug_bgr = dbgImg;
+        return R;
+    }
+
+    R.quarterTurns = (orientationOverride_ >= 0) ? (orientationOverride_ % 4)
+                                                 : detectQuarterTurns(gray, srcPoints);
+    if (R.quarterTurns != 0) {
+        srcPoints = orderTLTRBRBL(srcPoints, Point2f(gray.cols / 2.f, gray.rows / 2.f), R.quarterTurns);
+    }
+
+    if (debug_on) {
+        putText(dbgImg, "Yon: " + std::to_string(R.quarterTurns * 90) + " derece", {20, 100},
+                FONT_HERSHEY_SIMPLEX, 0.8, {0, 255, 255}, 2);
+        R.debug_bgr = dbgImg;
+    }
     
     std::vector<Point2f> dstPoints = {
         {0, 0},
@@ -147,16 +262,178 @@ CornerResult CornerFinder::processFrame(const Mat& bgr, bool debug_on) const {
         {0, (float)outH_ - 1}
     };
     
-    Mat H = getPerspectiveTransform(srcPoints, dstPoints);
-    
-    warpPerspective(gray, R.warped_gray, H, 
-                    Size(outW_, outH_), 
-                    INTER_LINEAR,
-                    BORDER_REPLICATE);
+    if (cam && !cam->empty()) {
+        // Köşeler ideal (bozulmasız) düzleme taşınır; homografi orada kurulur ve lens modeli
+        // ile birlikte tek bir remap tablosuna katlanır. Kare bir kez örneklenir.
+        std::vector<Point2f> idealPoints(4);
+        for (int i = 0; i < 4; ++i) idealPoints[i] = Point2f(cam->undistort(srcPoints[i]));
+        Mat idealH = getPerspectiveTransform(dstPoints, idealPoints);   // warp -> ideal
+        Mat map;
+        buildFusedWarpMap(idealH, *cam, Size(outW_, outH_), kFusedMapStep, map);
+        remap(gray, R.warped_gray, map, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    } else {
+        Mat H = getPerspectiveTransform(srcPoints, dstPoints);
+
+        warpPerspective(gray, R.warped_gray, H,
+                        Size(outW_, outH_),
+                        INTER_LINEAR,
+                        BORDER_REPLICATE);
+    }
     
     for(int i=0; i<4; ++i) R.markers_orig[i] = srcPoints[i];
     
     return R;
 }
 
+bool CornerFinder::findScanMarkers(const Mat& gray, const Mat& probe, double scale,
+                                   std::vector<Point2f>& corners) const {
+    // Temiz taramada global Otsu yeterli; adaptif eşik ve morfoloji gerekmez
+    Mat bin;
+    threshold(probe, bin, 0, 255, THRESH_BINARY_INV | THRESH_OTSU);
+
+    const int ww = cvRound(probe.cols * kScanCornerWindow);
+    const int wh = cvRound(probe.rows * kScanCornerWindow);
+    const Rect windows[4] = {
+        {0, 0, ww, wh}, {probe.cols - ww, 0, ww, wh},
+        {probe.cols - ww, probe.rows - wh, ww, wh}, {0, probe.rows - wh, ww, wh}
+    };
+
+    corners.assign(4, Point2f());
+    for (int k = 0; k < 4; ++k) {
+        const Rect& win = windows[k];
+        Mat labels, stats, centroids;
+        const int n = connectedComponentsWithStats(bin(win), labels, stats, centroids, 8, CV_32S);
+
+        int best = -1, bestArea = 0;
+        for (int i = 1; i < n; ++i) {
+            const int* st = stats.ptr<int>(i);
+            const int area = st[CC_STAT_AREA];
+            if (area < kScanMarkerMinArea || area <= bestArea) continue;
+
+            const Rect br(st[CC_STAT_LEFT], st[CC_STAT_TOP], st[CC_STAT_WIDTH], st[CC_STAT_HEIGHT]);
+            // Pencere kenarına değen bileşen kesik işaret ya da sayfa kenarı gölgesidir
+            if (br.x == 0 || br.y == 0 || br.br().x == win.width || br.br().y == win.height) continue;
+            const float ar = (float)br.width / br.height;
+            if (ar < 0.7f || ar > 1.4f) continue;
+            if (static_cast<double>(area) / br.area() < 0.65) continue;
+
+            best = i;
+            bestArea = area;
+        }
+        if (best < 0) return false;
+
+        // Tam çözünürlükte sadece işaretin çevresi eşiklenir: alt piksel ağırlık merkezi
+        const int* st = stats.ptr<int>(best);
+        const double pad = 0.5 * std::max(st[CC_STAT_WIDTH], st[CC_STAT_HEIGHT]) + 2.0;
+        const Rect fr = Rect(cvFloor((win.x + st[CC_STAT_LEFT] - pad) / scale),
+                             cvFloor((win.y + st[CC_STAT_TOP] - pad) / scale),
+                             cvCeil((st[CC_STAT_WIDTH] + 2.0 * pad) / scale),
+                             cvCeil((st[CC_STAT_HEIGHT] + 2.0 * pad) / scale))
+                        & Rect(0, 0, gray.cols, gray.rows);
+        if (fr.area() <= 0) return false;
+
+        Mat local;
+        threshold(gray(fr), local, 0, 255, THRESH_BINARY_INV | THRESH_OTSU);
+        Mat l2, s2, c2;
+        const int n2 = connectedComponentsWithStats(local, l2, s2, c2, 8, CV_32S);
+        int big = -1, bigArea = 0;
+        for (int i = 1; i < n2; ++i) {
+            const int area = s2.ptr<int>(i)[CC_STAT_AREA];
+            if (area > bigArea) { big = i; bigArea = area; }
+        }
+        if (big < 0) return false;
+
+        const double* ct = c2.ptr<double>(big);
+        corners[k] = Point2f(static_cast<float>(ct[0] + fr.x), static_cast<float>(ct[1] + fr.y));
+    }
+    return true;
+}
+
+CornerResult CornerFinder::processScan(const Mat& image) const {
+    CornerResult R;
+    if (image.empty()) return R;
+
+    Mat gray;
+    toSheetGray(image, dropout_, gray);
+
+    const double scale = std::min(1.0, static_cast<double>(kScanProbeWidth) / gray.cols);
+    Mat probe;
+    if (scale < 1.0) resize(gray, probe, Size(), scale, scale, INTER_AREA);
+    else probe = gray;
+
+    std::vector<Point2f> imageOrder;
+    if (!findScanMarkers(gray, probe, scale, imageOrder)) return R;
+
+    int q = 0;
+    if (orientationOverride_ >= 0) {
+        q = orientationOverride_ % 4;
+    } else {
+        // Yön imzası küçük kopyada örneklenir (ters beslenen kağıtlar)
+        std::vector<Point2f> probeOrder(4);
+        for (int i = 0; i < 4; ++i) probeOrder[i] = imageOrder[i] * static_cast<float>(scale);
+        q = detectQuarterTurns(probe, probeOrder);
+    }
+
+    std::vector<Point2f> src(4);
+    for (int i = 0; i < 4; ++i) src[i] = imageOrder[(i + q) % 4];
+    const Point2f dst[4] = {
+        {0, 0}, {(float)outW_ - 1, 0}, {(float)outW_ - 1, (float)outH_ - 1}, {0, (float)outH_ - 1}
+    };
+
+    // Benzerlik uyumu (en küçük kareler, kapalı form): görüntü = s·R·warp + t
+    //   x = a·u - b·v + tx,  y = b·u + a·v + ty
+    Point2d dc, sc;
+    for (int i = 0; i < 4; ++i) { dc += Point2d(dst[i]) * 0.25; sc += Point2d(src[i]) * 0.25; }
+    double sxx = 0.0, a = 0.0, b = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const Point2d p = Point2d(dst[i]) - dc, o = Point2d(src[i]) - sc;
+        sxx += p.x * p.x + p.y * p.y;
+        a += p.x * o.x + p.y * o.y;
+        b += p.x * o.y - p.y * o.x;
+    }
+    if (sxx <= 0.0) return R;
+    a /= sxx;
+    b /= sxx;
+    const double tx = sc.x - (a * dc.x - b * dc.y);
+    const double ty = sc.y - (b * dc.x + a * dc.y);
+    const double s = std::hypot(a, b);
+    if (s <= 0.0) return R;
+
+    // Köşeler benzerlikle açıklanamıyorsa (perspektif, kıvrık kağıt) tarayıcı girişi değildir
+    double maxErr = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const double px = a * dst[i].x - b * dst[i].y + tx;
+        const double py = b * dst[i].x + a * dst[i].y + ty;
+        maxErr = std::max(maxErr, std::hypot(px - src[i].x, py - src[i].y) / s);
+    }
+    if (maxErr > kScanMaxResidual * std::hypot(outW_, outH_)) return R;
+
+    const double angle = std::remainder(std::atan2(b, a) * 180.0 / CV_PI - q * 90.0, 360.0);
+    if (std::abs(angle) > kScanMaxAngleDeg) return R;
+
+    R.paper_ok = true;
+    R.quarterTurns = q;
+    for (int i = 0; i < 4; ++i) R.markers_orig[i] = src[i];
+
+    // Ölçek 1, dönme yok ve kayma tam sayıya yakınsa örnekleme yapılmaz: kopyasız kırpma
+    const double span = std::max(outW_, outH_) - 1.0;
+    const bool integral = std::abs(a - 1.0) * span <= kScanIntegerTol &&
+                          std::abs(b) * span <= kScanIntegerTol &&
+                          std::abs(tx - std::round(tx)) <= kScanIntegerTol &&
+                          std::abs(ty - std::round(ty)) <= kScanIntegerTol;
+    if (integral) {
+        const Rect crop(cvRound(tx), cvRound(ty), outW_, outH_);
+        if ((crop & Rect(0, 0, gray.cols, gray.rows)) == crop) {
+            R.warped_gray = gray(crop);
+            return R;
+        }
+    }
+
+    Mat_<double> M(2, 3);
+    M(0, 0) = a; M(0, 1) = -b; M(0, 2) = tx;
+    M(1, 0) = b; M(1, 1) = a;  M(1, 2) = ty;
+    warpAffine(gray, R.warped_gray, M, Size(outW_, outH_), INTER_LINEAR | WARP_INVERSE_MAP, BORDER_REPLICATE);
+    return R;
+}
+
 }
@@ -0,0 +1,84 @@
+#include "core/DarknessMap.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+void DarknessMap::build(const cv::Mat& gray) {
+    CV_Assert(gray.type() == CV_8UC1);
+
+    cv::integral(gray, integral_, CV_32S);
+
+    // Kağıt beyazı: küçült, max-filtre ile işaretleri / basılı çizgileri sil, yumuşat
+    whiteScale_ = 1.0 / std::max(1, params_.backgroundDiv);
+    cv::Mat small;
+    cv::resize(gray, small, cv::Size(), whiteScale_, whiteScale_, cv::INTER_AREA);
+    cv::dilate(small, small, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 5)));
+    cv::GaussianBlur(small, small, cv::Size(5, 5), 0);
+    small.convertTo(white_, CV_32F);
+}
+
+double DarknessMap::rectSum(const cv::Rect& r) const {
+    const int* top = integral_.ptr<int>(r.y);
+    const int* bot = integral_.ptr<int>(r.y + r.height);
+    return static_cast<double>(bot[r.x + r.width] - bot[r.x] - top[r.x + r.width] + top[r.x]);
+}
+
+double DarknessMap::paperWhite(cv::Point2f p) const {
+    int x = std::clamp(static_cast<int>(p.x * whiteScale_), 0, white_.cols - 1);
+    int y = std::clamp(static_cast<int>(p.y * whiteScale_), 0, white_.rows - 1);
+    return std::max(1.0f, white_.at<float>(y, x));
+}
+
+double DarknessMap::meanDarkness(const cv::Rect& rect) const {
+    if (empty()) return 0.0;
+    cv::Rect r = rect & cv::Rect(0, 0, integral_.cols - 1, integral_.rows - 1);
+    if (r.area() <= 0) return 0.0;
+
+    double mean = rectSum(r) / r.area();
+    double white = paperWhite(cv::Point2f(r.x + r.width * 0.5f, r.y + r.height * 0.5f));
+    return std::clamp(1.0 - mean / white, 0.0, 1.0);
+}
+
+double DarknessMap::bubbleScore(const cv::Rect2f& cell) const {
+    if (empty()) return 0.0;
+
+    const cv::Rect bounds(0, 0, integral_.cols - 1, integral_.rows - 1);
+    const cv::Point2f c(cell.x + cell.width * 0.5f, cell.y + cell.height * 0.5f);
+
+    // Bubble dairesinin iç karesi: çerçeve ve grid çizgileri dışarıda kalır
+    const float r = static_cast<float>(params_.bubbleRadius * std::min(cell.width, cell.height));
+    const float half = r * 0.7071f;
+    const float letterHalf = half * static_cast<float>(params_.letterFrac);
+
+    auto squareAt = [&](float h) {
+        return cv::Rect(cv::Point(cvRound(c.x - h), cvRound(c.y - h)),
+                        cv::Point(cvRound(c.x + h), cvRound(c.y + h))) & bounds;
+    };
+    cv::Rect outer = squareAt(half);
+    cv::Rect letter = squareAt(letterHalf);
+    if (outer.area() <= 0) return 0.0;
+
+    // Harf bölgesi letterWeight ile sayılır: (dış - (1-w) * harf) / (alan - (1-w) * harf alanı)
+    const double k = 1.0 - params_.letterWeight;
+    double sum = rectSum(outer) - (letter.area() > 0 ? k * rectSum(letter) : 0.0);
+    double area = outer.area() - (letter.area() > 0 ? k * letter.area() : 0.0);
+    if (area <= 0.0) return 0.0;
+
+    double darkness = 1.0 - (sum / area) / paperWhite(c);
+    return std::clamp(darkness / params_.fullDarkness, 0.0, 1.0);
+}
+
+void DarknessMap::scoreGrid(const cv::Rect& roi, int rows, int cols,
+                            std::vector<std::vector<double>>& out) const {
+    out.assign(std::max(0, rows), std::vector<double>(std::max(0, cols), 0.0));
+    if (empty() || rows <= 0 || cols <= 0) return;
+
+    const float cw = static_cast<float>(roi.width) / cols;
+    const float ch = static_cast<float>(roi.height) / rows;
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            out[r][c] = bubbleScore(cv::Rect2f(roi.x + c * cw, roi.y + r * ch, cw, ch));
+}
+
+}
@@ -0,0 +1,72 @@
+#include "core/DecodeTrace.hpp"
+#include <algorithm>
+
+namespace core {
+
+cv::Mat renderDecodeTrace(const cv::Mat& warped, const DecodeTrace& trace,
+                          cv::Size display, bool cells) {
+    if (warped.empty()) return cv::Mat();
+
+    // Pencere boyutuna küçült (tam çözünürlükte çizip imshow'a küçülttürmek yerine)
+    double s = 1.0;
+    if (display.width > 0 && display.height > 0) {
+        s = std::min(static_cast<double>(display.width) / warped.cols,
+                     static_cast<double>(display.height) / warped.rows);
+        s = std::min(s, 1.0);
+    }
+
+    cv::Mat view;
+    if (s < 1.0) cv::resize(warped, view, cv::Size(), s, s, cv::INTER_AREA);
+    else view = warped.clone();
+    if (view.channels() == 1) cv::cvtColor(view, view, cv::COLOR_GRAY2BGR);
+
+    const cv::Scalar green(0, 255, 0), gray(100, 100, 100), label(255, 0, 255);
+
+    for (const auto& rt : trace.regions) {
+        const cv::Rect2d roi(rt.roi.x * s, rt.roi.y * s, rt.roi.width * s, rt.roi.height * s);
+        const double cellW = rt.cols > 0 ? roi.width / rt.cols : 0.0;
+        const double cellH = rt.rows > 0 ? roi.height / rt.rows : 0.0;
+        const bool hasScores = rt.scores.size() == static_cast<size_t>(rt.rows) * rt.cols;
+
+        // Skor yazısı ancak hücre okunabilecek kadar büyükse
+        const bool drawText = std::min(cellW, cellH) >= 14.0;
+
+        auto cellRect = [&](int r, int c) {
+            return cv::Rect(cvRound(roi.x + c * cellW), cvRound(roi.y + r * cellH),
+                            std::max(1, cvRound(cellW)), std::max(1, cvRound(cellH)));
+        };
+
+        if (cells && rt.rows > 0 && rt.cols > 0) {
+            const int radius = std::max(1, static_cast<int>(std::min(cellW, cellH) * 0.35));
+            for (int r = 0; r < rt.rows; ++r) {
+                for (int c = 0; c < rt.cols; ++c) {
+                    cv::Point center(cvRound(roi.x + (c + 0.5) * cellW), cvRound(roi.y + (r + 0.5) * cellH));
+                    cv::circle(view, center, radius, gray, 1, cv::LINE_AA);
+
+                    const float v = hasScores ? rt.scores[r * rt.cols + c] : 0.f;
+                    if (drawText && v > 0.05f) {
+                        cv::putText(view, std::to_string(static_cast<int>(v * 100)),
+                                    center + cv::Point(-radius, radius / 2),
+                                    cv::FONT_HERSHEY_DUPLEX, 0.35, green, 1);
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < static_cast<int>(rt.picks.size()); ++i) {
+            const int p = rt.picks[i];
+            if (p < 0) continue;
+            const int r = rt.columnPicks ? p : i;
+            const int c = rt.columnPicks ? i : p;
+            cv::rectangle(view, cellRect(r, c), green, 2);
+        }
+
+        cv::rectangle(view, cv::Rect(cvRound(roi.x), cvRound(roi.y), cvRound(roi.width), cvRound(roi.height)),
+                      green, 1);
+        cv::putText(view, rt.name, cv::Point(cvRound(roi.x) + 3, cvRound(roi.y) + 12),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.4, label, 1);
+    }
+    return view;
+}
+
+}
@@ -0,0 +1,40 @@
+#include "core/Dropout.hpp"
+
+namespace core {
+
+bool parseDropoutChannel(const std::string& s, DropoutChannel& out) {
+    if (s == "none" || s == "off") { out = DropoutChannel::None; return true; }
+    if (s == "red" || s == "kirmizi") { out = DropoutChannel::Red; return true; }
+    if (s == "green" || s == "yesil") { out = DropoutChannel::Green; return true; }
+    if (s == "blue" || s == "mavi") { out = DropoutChannel::Blue; return true; }
+    return false;
+}
+
+const char* dropoutChannelName(DropoutChannel c) {
+    switch (c) {
+        case DropoutChannel::None:  return "none";
+        case DropoutChannel::Red:   return "red";
+        case DropoutChannel::Green: return "green";
+        case DropoutChannel::Blue:  return "blue";
+    }
+    return "none";
+}
+
+int dropoutChannelIndex(DropoutChannel c) {
+    switch (c) {
+        case DropoutChannel::Red:   return 2;
+        case DropoutChannel::Green: return 1;
+        case DropoutChannel::Blue:  return 0;
+        default:                    return -1;
+    }
+}
+
+void toSheetGray(const cv::Mat& image, DropoutChannel c, cv::Mat& out) {
+    if (image.channels() == 1) { out = image; return; }
+
+    const int idx = dropoutChannelIndex(c);
+    if (idx < 0 || image.channels() < 3) cv::cvtColor(image, out, cv::COLOR_BGR2GRAY);
+    else cv::extractChannel(image, out, idx);
+}
+
+}
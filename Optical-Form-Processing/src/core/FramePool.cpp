@@ -0,0 +1,64 @@
+#include "core/FramePool.hpp"
+
+namespace core {
+
+FramePool::Lease::Lease(Lease&& o) noexcept
+    : pool_(o.pool_), slot_(o.slot_), detached_(std::move(o.detached_)) {
+    o.pool_ = nullptr;
+    o.slot_ = -1;
+}
+
+FramePool::Lease& FramePool::Lease::operator=(Lease&& o) noexcept {
+    if (this != &o) {
+        release();
+        pool_ = o.pool_;
+        slot_ = o.slot_;
+        detached_ = std::move(o.detached_);
+        o.pool_ = nullptr;
+        o.slot_ = -1;
+    }
+    return *this;
+}
+
+cv::Mat& FramePool::Lease::mat() {
+    if (pool_ && slot_ >= 0) return pool_->slots_[slot_].buf;
+    return detached_;
+}
+
+void FramePool::Lease::release() {
+    if (!pool_) return;
+    pool_->giveBack(slot_, detached_);
+    pool_ = nullptr;
+    slot_ = -1;
+    detached_.release();
+}
+
+FramePool::Lease FramePool::acquire() {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        if (!slots_[i].leased) {
+            slots_[i].leased = true;
+            slots_[i].data = slots_[i].buf.data;
+            return Lease(this, static_cast<int>(i));
+        }
+    }
+    if (slots_.size() < capacity_) {
+        slots_.push_back(Slot());
+        slots_.back().leased = true;
+        return Lease(this, static_cast<int>(slots_.size() - 1));
+    }
+    return Lease(this, -1);
+}
+
+void FramePool::giveBack(int slot, const cv::Mat& detached) {
+    if (slot < 0) {
+        if (detached.u) allocations_++;
+        return;
+    }
+    Slot& s = slots_[slot];
+    // Okuyucu tamponu yeniden ayırdıysa (ilk kare, boyut değişimi, dosyadan decode) sayılır.
+    // Dış belleğe bakan görünümler (ör. V4L2 mmap tamponu) ayırma değildir.
+    if (s.buf.u && s.buf.data != s.data) allocations_++;
+    s.leased = false;
+}
+
+}
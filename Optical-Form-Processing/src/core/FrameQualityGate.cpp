@@ -0,0 +1,82 @@
+#include "core/FrameQualityGate.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+const char* QualityVerdict::text() const {
+    switch (reason) {
+        case Reason::Ok:              return "OK";
+        case Reason::Blurry:          return "BULANIK";
+        case Reason::Moving:          return "HAREKETLI";
+        case Reason::CornersUnstable: return "KOSELER OYNUYOR";
+    }
+    return "?";
+}
+
+QualityVerdict FrameQualityGate::checkFrame(const cv::Mat& frame) {
+    QualityVerdict v;
+    if (frame.empty()) {
+        v.decode = false;
+        v.reason = QualityVerdict::Reason::Blurry;
+        return last_ = v;
+    }
+
+    // Önce küçült, sonra griye çevir: tam kare üzerinde hiçbir işlem yapılmaz
+    double scale = std::min(1.0, static_cast<double>(params_.probeWidth) / frame.cols);
+    cv::Mat small, gray;
+    cv::resize(frame, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    if (small.channels() == 3) cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    else gray = small;
+
+    cv::Mat lap;
+    cv::Laplacian(gray, lap, CV_16S, 3);
+    cv::Scalar mu, sigma;
+    cv::meanStdDev(lap, mu, sigma);
+    v.sharpness = sigma[0] * sigma[0];
+
+    // Hareket yalnızca aynı alanın örnekleri arasında anlamlıdır: çağıran her karede aynı
+    // bölgeyi (tam kare) verir; boyut değişirse (kaynak çözünürlüğü) bu karede ölçülmez
+    if (!prevSmall_.empty() && prevSmall_.size() == gray.size()) {
+        cv::Mat diff;
+        cv::absdiff(gray, prevSmall_, diff);
+        v.motion = cv::mean(diff)[0];
+    }
+    prevSmall_ = gray;
+
+    if (v.sharpness < params_.minSharpness) {
+        v.decode = false;
+        v.reason = QualityVerdict::Reason::Blurry;
+    } else if (v.motion > params_.maxMotion) {
+        v.decode = false;
+        v.reason = QualityVerdict::Reason::Moving;
+    }
+
+    if (!v.decode) hasCorners_ = false;
+    return last_ = v;
+}
+
+QualityVerdict FrameQualityGate::checkCorners(const std::array<cv::Point2f, 4>& corners) {
+    QualityVerdict v = last_;
+
+    double shift = 0.0;
+    if (hasCorners_) {
+        for (int i = 0; i < 4; ++i) {
+            cv::Point2f d = corners[i] - prevCorners_[i];
+            shift = std::max(shift, static_cast<double>(std::hypot(d.x, d.y)));
+        }
+    }
+    v.cornerShift = shift;
+
+    // İlk tespit henüz doğrulanmadı: bir sonraki karede aynı yerde olmalı
+    if (!hasCorners_ || shift > params_.maxCornerShiftPx) {
+        v.decode = false;
+        v.reason = QualityVerdict::Reason::CornersUnstable;
+    }
+
+    prevCorners_ = corners;
+    hasCorners_ = true;
+    return last_ = v;
+}
+
+}
@@ -0,0 +1,178 @@
+#include "core/FrameSource.hpp"
+#include "core/BatchRunner.hpp"
+#include "core/V4l2Source.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Bu kadar geride kalınırsa yetişmeye çalışmak yerine zaman çizelgesi sıfırlanır
+constexpr double kMaxLagMs = 250.0;
+
+} // namespace
+
+/* ---------------- ReplayPacer ---------------- */
+
+void ReplayPacer::wait(double frameTsMs) {
+    if (pacing_ == Pacing::AsFastAsPossible) return;
+
+    auto now = Clock::now();
+    if (!started_) {
+        started_ = true;
+        ts0_ = frameTsMs;
+        wall0_ = now;
+        return;
+    }
+
+    double dueMs = frameTsMs - ts0_;
+    double elapsedMs = std::chrono::duration<double, std::milli>(now - wall0_).count();
+
+    if (elapsedMs - dueMs > kMaxLagMs) {
+        ts0_ = frameTsMs;
+        wall0_ = now;
+        return;
+    }
+
+    if (dueMs > elapsedMs) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(dueMs - elapsedMs));
+    }
+}
+
+/* ---------------- CameraSource ---------------- */
+
+CameraSource::CameraSource(int index, cv::Size size, double fps)
+    : cap_(index, cv::CAP_ANY), index_(index) {
+    if (!cap_.isOpened()) return;
+
+    cap_.set(cv::CAP_PROP_FRAME_WIDTH, size.width);
+    cap_.set(cv::CAP_PROP_FRAME_HEIGHT, size.height);
+    cap_.set(cv::CAP_PROP_FPS, fps);
+    cap_.set(cv::CAP_PROP_AUTOFOCUS, 1);
+    t0_ = Clock::now();
+}
+
+bool CameraSource::read(cv::Mat& frame) {
+    if (!cap_.read(frame) || frame.empty()) return false;
+    tsMs_ = std::chrono::duration<double, std::milli>(Clock::now() - t0_).count();
+    return true;
+}
+
+std::string CameraSource::describe() const {
+    return "kamera " + std::to_string(index_);
+}
+
+/* ---------------- VideoFileSource ---------------- */
+
+VideoFileSource::VideoFileSource(const std::string& path, Pacing pacing)
+    : cap_(path, cv::CAP_ANY), path_(path), pacer_(pacing) {
+    if (!cap_.isOpened()) return;
+    double f = cap_.get(cv::CAP_PROP_FPS);
+    if (f > 1.0 && f < 1000.0) fps_ = f;
+}
+
+bool VideoFileSource::read(cv::Mat& frame) {
+    if (!cap_.read(frame) || frame.empty()) return false;
+
+    // Konteyner zaman damgası yoksa kare sırasından hesapla
+    double pos = cap_.get(cv::CAP_PROP_POS_MSEC);
+    tsMs_ = (pos > 0.0) ? pos : frameIndex_ * 1000.0 / fps_;
+    ++frameIndex_;
+
+    pacer_.wait(tsMs_);
+    return true;
+}
+
+std::string VideoFileSource::describe() const {
+    return "video " + path_;
+}
+
+/* ---------------- ImageSequenceSource ---------------- */
+
+ImageSequenceSource::ImageSequenceSource(const std::string& spec, double fps, Pacing pacing)
+    : spec_(spec), pacer_(pacing), fps_(fps > 0.0 ? fps : 30.0) {
+    if (spec.find('*') != std::string::npos || spec.find('?') != std::string::npos) {
+        cv::glob(spec, paths_, false);
+        std::sort(paths_.begin(), paths_.end());
+    } else {
+        paths_ = collectImagePaths({spec});
+    }
+}
+
+bool ImageSequenceSource::read(cv::Mat& frame) {
+    while (index_ < paths_.size()) {
+        size_t i = index_++;
+        frame = cv::imread(paths_[i], cv::IMREAD_COLOR);
+        if (frame.empty()) continue; // Bozuk dosyayı atla
+
+        tsMs_ = i * 1000.0 / fps_;
+        pacer_.wait(tsMs_);
+        return true;
+    }
+    return false;
+}
+
+std::string ImageSequenceSource::describe() const {
+    return "goruntu dizisi " + spec_ + " (" + std::to_string(paths_.size()) + " kare)";
+}
+
+/* ---------------- Factory ---------------- */
+
+std::unique_ptr<FrameSource> openFrameSource(const FrameSourceSpec& spec, std::string& err) {
+    switch (spec.kind) {
+        case FrameSourceSpec::Kind::Camera: {
+            auto s = std::make_unique<CameraSource>(spec.cameraIndex);
+            if (!s->isOpened()) {
+                err = "Kamera acilamadi! Index: " + std::to_string(spec.cameraIndex);
+                return nullptr;
+            }
+            return s;
+        }
+        case FrameSourceSpec::Kind::Video: {
+            auto s = std::make_unique<VideoFileSource>(spec.path, spec.pacing);
+            if (!s->isOpened()) {
+                err = "Video acilamadi: " + spec.path;
+                return nullptr;
+            }
+            return s;
+        }
+        case FrameSourceSpec::Kind::Images: {
+            auto s = std::make_unique<ImageSequenceSource>(spec.path, spec.sequenceFps, spec.pacing);
+            if (!s->isOpened()) {
+                err = "Goruntu bulunamadi: " + spec.path;
+                return nullptr;
+            }
+            return s;
+        }
+        case FrameSourceSpec::Kind::V4l2: {
+            V4l2Options opt;
+            opt.device = spec.path;
+            opt.size = spec.frameSize;
+            opt.format = spec.lumaFormat;
+            opt.bufferCount = spec.bufferCount;
+            auto s = std::make_unique<V4l2CameraSource>(opt);
+            if (!s->isOpened()) {
+                err = "V4L2 kamera acilamadi: " + s->error();
+                return nullptr;
+            }
+            return s;
+        }
+        case FrameSourceSpec::Kind::RawLuma: {
+            auto s = std::make_unique<RawLumaFileSource>(spec.path, spec.lumaFormat, spec.frameSize,
+                                                         spec.sequenceFps, spec.pacing);
+            if (!s->isOpened()) {
+                err = "Ham kayit acilamadi: " + spec.path;
+                return nullptr;
+            }
+            return s;
+        }
+    }
+    err = "Bilinmeyen kaynak";
+    return nullptr;
+}
+
+}
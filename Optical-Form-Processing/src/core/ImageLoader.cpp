@@ -0,0 +1,111 @@
+#include "core/ImageLoader.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace core {
+
+namespace {
+
+// Köşe işaretleri taranan sayfanın ~%90'ını kaplar; warp'ın büyütme
+// yapmaması için kaynakta bu kadar pay bırakılır.
+constexpr double kSheetCoverage = 0.90;
+
+int be16(const std::vector<uchar>& b, size_t i) {
+    return (static_cast<int>(b[i]) << 8) | b[i + 1];
+}
+
+bool isJpeg(const std::vector<uchar>& b) {
+    return b.size() > 4 && b[0] == 0xFF && b[1] == 0xD8;
+}
+
+} // namespace
+
+bool readFileBytes(const std::string& path, std::vector<uchar>& bytes) {
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) return false;
+
+    std::streamsize n = f.tellg();
+    if (n <= 0) return false;
+    f.seekg(0);
+
+    bytes.resize(static_cast<size_t>(n));
+    return static_cast<bool>(f.read(reinterpret_cast<char*>(bytes.data()), n));
+}
+
+bool readJpegSize(const std::vector<uchar>& b, cv::Size& size) {
+    if (!isJpeg(b)) return false;
+
+    size_t i = 2;
+    while (i + 3 < b.size()) {
+        if (b[i] != 0xFF) return false;
+        uchar m = b[i + 1];
+
+        // Dolgu baytları
+        if (m == 0xFF) { ++i; continue; }
+
+        // Uzunluksuz işaretler
+        if (m == 0x01 || (m >= 0xD0 && m <= 0xD8)) { i += 2; continue; }
+        if (m == 0xD9 || m == 0xDA) return false; // SOF'tan önce tarama başladı
+
+        int len = be16(b, i + 2);
+        if (len < 2) return false;
+
+        // SOF0..SOF15 (DHT=C4, JPG=C8, DAC=CC hariç)
+        bool isSof = (m >= 0xC0 && m <= 0xCF) && m != 0xC4 && m != 0xC8 && m != 0xCC;
+        if (isSof) {
+            if (i + 8 >= b.size()) return false;
+            size.height = be16(b, i + 5);
+            size.width = be16(b, i + 7);
+            return size.width > 0 && size.height > 0;
+        }
+
+        i += 2 + static_cast<size_t>(len);
+    }
+    return false;
+}
+
+int chooseReduction(cv::Size source, cv::Size needed) {
+    // Taramalar yatay da gelebilir: kısa kenar kısa kenarla karşılaştırılır
+    int srcShort = std::min(source.width, source.height);
+    int srcLong = std::max(source.width, source.height);
+    double needShort = std::min(needed.width, needed.height) / kSheetCoverage;
+    double needLong = std::max(needed.width, needed.height) / kSheetCoverage;
+
+    for (int f : {8, 4, 2}) {
+        if (srcShort / f >= needShort && srcLong / f >= needLong) return f;
+    }
+    return 1;
+}
+
+cv::Mat decodeGrayForWarp(const std::vector<uchar>& bytes, cv::Size needed, DropoutChannel dropout) {
+    if (bytes.empty()) return cv::Mat();
+
+    // Dropout modunda renk gerekir; yine de DCT ölçeklemesiyle küçültülmüş açılır
+    const bool color = dropoutChannelIndex(dropout) >= 0;
+    int flags = color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+    cv::Size src;
+    if (readJpegSize(bytes, src)) {
+        switch (chooseReduction(src, needed)) {
+            case 8: flags = color ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8; break;
+            case 4: flags = color ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4; break;
+            case 2: flags = color ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2; break;
+            default: break;
+        }
+    }
+
+    // imdecode vektörü kopyalamadan sarar
+    cv::Mat img = cv::imdecode(bytes, flags);
+    if (!color || img.empty()) return img;
+
+    cv::Mat channel;
+    toSheetGray(img, dropout, channel);
+    return channel;
+}
+
+cv::Mat loadGrayForWarp(const std::string& path, cv::Size needed, DropoutChannel dropout) {
+    std::vector<uchar> bytes;
+    if (!readFileBytes(path, bytes)) return cv::Mat();
+    return decodeGrayForWarp(bytes, needed, dropout);
+}
+
+}
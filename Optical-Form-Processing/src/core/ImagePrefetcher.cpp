@@ -0,0 +1,240 @@
+#include "core/ImagePrefetcher.hpp"
+#include "core/ThreadBudget.hpp"
+#include "core/ImageLoader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#ifdef OMR_HAVE_IO_URING
+#include <liburing.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+ImagePrefetcher::ImagePrefetcher(const std::vector<std::string>& paths, const Options& opt)
+    : paths_(paths),
+      opt_(opt),
+      rawQueue_(opt.maxPendingFiles),
+      readyQueue_(opt.maxReadyImages) {
+
+    int decoders = std::max(1, opt_.decodeThreads);
+    activeDecoders_ = decoders;
+
+#ifdef OMR_HAVE_IO_URING
+    if (opt_.useIoUring) {
+        // Tek thread tüm okumaları kuyruk derinliği kadar paralel yürütür
+        activeReaders_ = 1;
+        threads_.emplace_back([this] {
+            if (!readLoopUring()) readLoopBlocking();
+            finishReader();
+        });
+    } else
+#endif
+    {
+        int readers = std::max(1, opt_.readThreads);
+        activeReaders_ = readers;
+        for (int i = 0; i < readers; ++i) {
+            threads_.emplace_back([this] {
+                readLoopBlocking();
+                finishReader();
+            });
+        }
+    }
+
+    for (int i = 0; i < decoders; ++i) {
+        threads_.emplace_back([this, i] {
+            if (opt_.pinFirstSlot >= 0) pinCurrentThread(opt_.pinFirstSlot + i);
+            decodeLoop();
+        });
+    }
+}
+
+ImagePrefetcher::~ImagePrefetcher() {
+    // Tüketici erken bıraktıysa üreticileri uyandır
+    rawQueue_.close();
+    readyQueue_.close();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void ImagePrefetcher::finishReader() {
+    if (--activeReaders_ == 0) rawQueue_.close();
+}
+
+void ImagePrefetcher::readLoopBlocking() {
+    for (size_t i = nextPath_++; i < paths_.size(); i = nextPath_++) {
+        RawFile raw;
+        raw.index = i;
+
+        auto t0 = Clock::now();
+        raw.ok = readFileBytes(paths_[i], raw.bytes);
+        raw.readMs = msSince(t0);
+        addMs(ioWaitUs_, raw.readMs);
+
+        bytesRead_ += raw.bytes.size();
+        if (!rawQueue_.push(std::move(raw))) return;
+    }
+}
+
+#ifdef OMR_HAVE_IO_URING
+bool ImagePrefetcher::readLoopUring() {
+    io_uring ring;
+    const int depth = std::max(1, opt_.ioDepth);
+    if (io_uring_queue_init(depth, &ring, 0) < 0) return false;
+    usedIoUring_ = true;
+
+    struct Pending {
+        RawFile raw;
+        int fd = -1;
+        size_t done = 0;
+        Clock::time_point start;
+    };
+
+    auto submitRead = [&](Pending* p) {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+        io_uring_prep_read(sqe, p->fd, p->raw.bytes.data() + p->done,
+                           static_cast<unsigned>(p->raw.bytes.size() - p->done), p->done);
+        io_uring_sqe_set_data(sqe, p);
+    };
+
+    auto finish = [&](std::unique_ptr<Pending> p, bool ok) {
+        if (p->fd >= 0) ::close(p->fd);
+        p->raw.ok = ok;
+        if (ok) p->raw.bytes.resize(p->done);
+        p->raw.readMs = msSince(p->start);
+        bytesRead_ += p->done;
+        return rawQueue_.push(std::move(p->raw));
+    };
+
+    int inflight = 0;
+    bool stopped = false;
+
+    while (!stopped) {
+        // Kuyruğu doldur
+        while (inflight < depth) {
+            size_t i = nextPath_++;
+            if (i >= paths_.size()) break;
+
+            auto p = std::make_unique<Pending>();
+            p->raw.index = i;
+            p->start = Clock::now();
+
+            struct stat st{};
+            p->fd = open(paths_[i].c_str(), O_RDONLY | O_CLOEXEC);
+            if (p->fd < 0 || fstat(p->fd, &st) != 0 || st.st_size <= 0) {
+                if (!finish(std::move(p), false)) { stopped = true; break; }
+                continue;
+            }
+
+            p->raw.bytes.resize(static_cast<size_t>(st.st_size));
+            submitRead(p.release());
+            ++inflight;
+        }
+
+        if (inflight == 0) break;
+        io_uring_submit(&ring);
+
+        // Sadece kernel'den tamamlanma beklenen süre G/Ç beklemesidir
+        auto t0 = Clock::now();
+        io_uring_cqe* cqe = nullptr;
+        int rc = io_uring_wait_cqe(&ring, &cqe);
+        addMs(ioWaitUs_, msSince(t0));
+        if (rc < 0) break;
+
+        std::unique_ptr<Pending> p(static_cast<Pending*>(io_uring_cqe_get_data(cqe)));
+        int res = cqe->res;
+        io_uring_cqe_seen(&ring, cqe);
+        --inflight;
+
+        if (res < 0) {
+            if (!finish(std::move(p), false)) stopped = true;
+            continue;
+        }
+
+        p->done += static_cast<size_t>(res);
+        if (res > 0 && p->done < p->raw.bytes.size()) {
+            // Ağ dosya sistemlerinde kısa okuma olabilir: kalanını tekrar iste
+            submitRead(p.release());
+            ++inflight;
+            continue;
+        }
+
+        if (!finish(std::move(p), true)) stopped = true;
+    }
+
+    // Yarıda kalan okumaları topla
+    while (inflight > 0) {
+        io_uring_cqe* cqe = nullptr;
+        if (io_uring_wait_cqe(&ring, &cqe) < 0) break;
+        std::unique_ptr<Pending> p(static_cast<Pending*>(io_uring_cqe_get_data(cqe)));
+        io_uring_cqe_seen(&ring, cqe);
+        if (p->fd >= 0) ::close(p->fd);
+        --inflight;
+    }
+
+    io_uring_queue_exit(&ring);
+    return true;
+}
+#else
+bool ImagePrefetcher::readLoopUring() {
+    return false;
+}
+#endif
+
+void ImagePrefetcher::decodeLoop() {
+    RawFile raw;
+    while (rawQueue_.pop(raw)) {
+        Item item;
+        item.index = raw.index;
+        item.path = paths_[raw.index];
+        item.readMs = raw.readMs;
+
+        if (raw.ok) {
+            auto t0 = Clock::now();
+            item.gray = decodeGrayForWarp(raw.bytes, opt_.needed, opt_.dropout);
+            item.decodeMs = msSince(t0);
+            addMs(decodeUs_, item.decodeMs);
+        }
+
+        // Sıkıştırılmış baytları decode biter bitmez bırak
+        std::vector<uchar>().swap(raw.bytes);
+
+        if (!readyQueue_.push(std::move(item))) break;
+    }
+
+    if (--activeDecoders_ == 0) readyQueue_.close();
+}
+
+bool ImagePrefetcher::next(Item& out) {
+    auto t0 = Clock::now();
+    bool ok = readyQueue_.pop(out);
+    addMs(consumerWaitUs_, msSince(t0));
+    return ok;
+}
+
+ImagePrefetcher::Stats ImagePrefetcher::stats() const {
+    Stats s;
+    s.ioWaitMs = ioWaitUs_ / 1000.0;
+    s.decodeMs = decodeUs_ / 1000.0;
+    s.consumerWaitMs = consumerWaitUs_ / 1000.0;
+    s.bytesRead = bytesRead_;
+    s.usedIoUring = usedIoUring_;
+    return s;
+}
+
+}
@@ -0,0 +1,69 @@
+#include "core/OverlayLayer.hpp"
+
+namespace core {
+
+void OverlayLayer::begin(cv::Size frameSize) {
+    if (canvas_.size() != frameSize) {
+        canvas_.create(frameSize, CV_8UC3);
+        alpha_.create(frameSize, CV_8U);
+    }
+    canvas_.setTo(cv::Scalar::all(0));
+    alpha_.setTo(cv::Scalar::all(0));
+    bounds_ = cv::Rect();
+    valid_ = false;
+}
+
+void OverlayLayer::end() {
+    bounds_ = alpha_.empty() ? cv::Rect() : cv::boundingRect(alpha_);
+    valid_ = true;
+}
+
+void OverlayLayer::putText(const std::string& text, cv::Point org, double fontScale,
+                           const cv::Scalar& color, int thickness, double alpha) {
+    cv::putText(canvas_, text, org, cv::FONT_HERSHEY_SIMPLEX, fontScale, color, thickness);
+    cv::putText(alpha_, text, org, cv::FONT_HERSHEY_SIMPLEX, fontScale, cv::Scalar(alphaByte(alpha)), thickness);
+}
+
+void OverlayLayer::fillRect(const cv::Rect& r, const cv::Scalar& color, double alpha) {
+    const cv::Rect c = r & cv::Rect(0, 0, canvas_.cols, canvas_.rows);
+    if (c.area() <= 0) return;
+    canvas_(c).setTo(color);
+    alpha_(c).setTo(cv::Scalar(alphaByte(alpha)));
+}
+
+void OverlayLayer::rectangle(const cv::Rect& r, const cv::Scalar& color, int thickness, double alpha) {
+    cv::rectangle(canvas_, r, color, thickness);
+    cv::rectangle(alpha_, r, cv::Scalar(alphaByte(alpha)), thickness);
+}
+
+void OverlayLayer::line(cv::Point a, cv::Point b, const cv::Scalar& color, int thickness, double alpha) {
+    cv::line(canvas_, a, b, color, thickness);
+    cv::line(alpha_, a, b, cv::Scalar(alphaByte(alpha)), thickness);
+}
+
+void OverlayLayer::composite(cv::Mat& frame) const {
+    if (!valid_ || bounds_.area() <= 0 || frame.size() != canvas_.size() || frame.type() != CV_8UC3) return;
+
+    for (int y = bounds_.y; y < bounds_.y + bounds_.height; ++y) {
+        const uchar* a = alpha_.ptr<uchar>(y);
+        const uchar* src = canvas_.ptr<uchar>(y);
+        uchar* dst = frame.ptr<uchar>(y);
+
+        for (int x = bounds_.x; x < bounds_.x + bounds_.width; ++x) {
+            const int w = a[x];
+            if (w == 0) continue;
+            uchar* d = dst + 3 * x;
+            const uchar* s = src + 3 * x;
+            if (w == 255) {
+                d[0] = s[0]; d[1] = s[1]; d[2] = s[2];
+                continue;
+            }
+            const int iw = 255 - w;
+            d[0] = static_cast<uchar>((s[0] * w + d[0] * iw + 127) / 255);
+            d[1] = static_cast<uchar>((s[1] * w + d[1] * iw + 127) / 255);
+            d[2] = static_cast<uchar>((s[2] * w + d[2] * iw + 127) / 255);
+        }
+    }
+}
+
+}
@@ -1,4 +1,5 @@
 #include "core/PerspectiveCorrector.hpp"
+#include "core/WarpProfile.hpp"
 using namespace cv;
 
 namespace core {
@@ -7,10 +8,19 @@ PerspectiveCorrector::PerspectiveCorrector(int outW, int outH)
     : outW_(outW), outH_(outH), finder_(outW, outH) {}
 
 WarpResult PerspectiveCorrector::findAndWarp(const cv::Mat& bgr, bool wantDebug) const {
+    return warpImpl(bgr, wantDebug, bgr.size(), cv::Point());
+}
+
+WarpResult PerspectiveCorrector::warpImpl(const cv::Mat& bgr, bool wantDebug,
+                                          cv::Size frameSize, cv::Point origin) const {
     WarpResult R;
     if (bgr.empty()) return R;
 
-    CornerResult C = finder_.processFrame(bgr, wantDebug);
+    // Ana nokta tam kareye göre; pencerede arama yapılıyorsa kaydırılır
+    CameraProfile cam;
+    if (!camera_.empty()) cam = camera_.adjusted(frameSize, origin);
+
+    CornerResult C = finder_.processFrame(bgr, wantDebug, cam.empty() ? nullptr : &cam);
     if (wantDebug) R.debug = C.debug_bgr.empty() ? bgr.clone() : C.debug_bgr;
 
     if (!C.paper_ok) {
@@ -18,9 +28,19 @@ WarpResult PerspectiveCorrector::findAndWarp(const cv::Mat& bgr, bool wantDebug)
         return R;
     }
 
+    R.corners = C.markers_orig;
+    R.quarterTurns = C.quarterTurns;
+
+    if (finder_.dropoutChannel() != DropoutChannel::None) {
+        // Grid kanalda yok: kontrast / gürültü temizliği gereksiz, warp doğrudan okunur
+        R.warped = C.warped_gray;
+        R.ok = !R.warped.empty();
+        return R;
+    }
+
     cv::Mat warpedGray = C.warped_gray.clone();
     cv::Mat denoised;
-    cv::bilateralFilter(warpedGray, denoised, 9, 100, 100);
+    cv::bilateralFilter(warpedGray, denoised, scaledKernel(9, kernelScale_), 100, 100);
 
     cv::Ptr<CLAHE> clahe = cv::createCLAHE();
     clahe->setClipLimit(2.0);
@@ -29,7 +49,8 @@ WarpResult PerspectiveCorrector::findAndWarp(const cv::Mat& bgr, bool wantDebug)
     clahe->apply(denoised, enhanced);
 
     cv::Mat blurred;
-    cv::GaussianBlur(enhanced, blurred, cv::Size(5, 5), 1.0);
+    const int blurK = scaledKernel(5, kernelScale_);
+    cv::GaussianBlur(enhanced, blurred, cv::Size(blurK, blurK), 1.0 * kernelScale_);
     cv::Mat sharpened;
     cv::addWeighted(enhanced, 1.2, blurred, -0.2, 0, sharpened);
 
@@ -37,10 +58,50 @@ WarpResult PerspectiveCorrector::findAndWarp(const cv::Mat& bgr, bool wantDebug)
     cv::cvtColor(sharpened, warpedBgr, cv::COLOR_GRAY2BGR);
 
     R.warped = warpedBgr;
-    R.corners = C.markers_orig;
     R.ok = !R.warped.empty();
 
     return R;
 }
 
+WarpResult PerspectiveCorrector::findAndWarp(const cv::Mat& frame, bool wantDebug, const cv::Rect& window) const {
+    const cv::Rect w = window & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (w.area() <= 0 || w.size() == frame.size()) return findAndWarp(frame, wantDebug);
+
+    // Pencere görünümü kopyasızdır; gri dönüşüm ve eşikleme sadece pencere alanında yapılır
+    WarpResult R = warpImpl(frame(w), wantDebug, frame.size(), w.tl());
+    if (R.ok) {
+        const cv::Point2f off(static_cast<float>(w.x), static_cast<float>(w.y));
+        for (auto& c : R.corners) c += off;
+    }
+
+    // Ekran görüntüsü her zaman kare boyutunda kalmalı (HUD / katmanlar kare boyutuna bağlı):
+    // pencerenin debug çizimi tam karenin kopyasına yerleştirilir
+    if (wantDebug && !R.debug.empty()) {
+        cv::Mat canvas;
+        if (frame.channels() == 1) cv::cvtColor(frame, canvas, cv::COLOR_GRAY2BGR);
+        else frame.copyTo(canvas);
+        cv::Mat roi = canvas(w);
+        if (R.debug.channels() == 1) cv::cvtColor(R.debug, roi, cv::COLOR_GRAY2BGR);
+        else R.debug.copyTo(roi);
+        cv::rectangle(canvas, w, cv::Scalar(255, 128, 0), 2);
+        R.debug = canvas;
+    }
+    return R;
+}
+
+WarpResult PerspectiveCorrector::alignScan(const cv::Mat& image) const {
+    WarpResult R;
+    if (image.empty()) return R;
+
+    CornerResult C = finder_.processScan(image);
+    if (!C.paper_ok) return findAndWarp(image, false);
+
+    R.warped = C.warped_gray;
+    R.corners = C.markers_orig;
+    R.quarterTurns = C.quarterTurns;
+    R.scanAligned = true;
+    R.ok = !R.warped.empty();
+    return R;
+}
+
 }
@@ -1,4 +1,6 @@
 #include "ROIDetector.hpp"
+#include "WarpProfile.hpp"
+#include "StandardForm.hpp"
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <algorithm>
@@ -10,28 +12,22 @@ using namespace std;
 
 namespace {
 
-cv::Rect rectPct(const cv::Mat& img, float x, float y, float w, float h) {
-    int X = static_cast<int>(x * img.cols);
-    int Y = static_cast<int>(y * img.rows);
-    int W = static_cast<int>(w * img.cols);
-    int H = static_cast<int>(h * img.rows);
-    return cv::Rect(X, Y, W, H);
-}
-
-static cv::Mat preprocessForFill(const cv::Mat& roiGray) {
+static cv::Mat preprocessForFill(const cv::Mat& roiGray, double scale = 1.0) {
     cv::Mat blurImg, thr;
-    cv::GaussianBlur(roiGray, blurImg, cv::Size(5, 5), 0);
+    const int blurK = core::scaledKernel(5, scale);
+    cv::GaussianBlur(roiGray, blurImg, cv::Size(blurK, blurK), 0);
 
     // Daha agresif adaptive threshold
     cv::adaptiveThreshold(
         blurImg, thr, 255,
         cv::ADAPTIVE_THRESH_GAUSSIAN_C,
         cv::THRESH_BINARY_INV,
-        15, 3
+        core::scaledKernel(15, scale), 3
     );
 
     // Küçük gürültüleri temizle (morfolojik opening)
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(2, 2));
+    const int morphK = core::scaledKernel(2, scale, false);
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(morphK, morphK));
     cv::morphologyEx(thr, thr, cv::MORPH_OPEN, kernel);
 
     return thr;
@@ -183,11 +179,18 @@ static std::string detectGridByColumns_AsLetters_SkipFirstRow(
     return out;
 }
 
+// Ad soyad gridinin satır harfleri (Ç, Ğ, İ, Ö, Ş, Ü ASCII karşılıklarıyla)
+const std::vector<std::string> kNameAlphabet = {
+    "A","B","C","C","D","E","F","G","G","H","I","I","J","K","L","M",
+    "N","O","O","P","R","S","S","T","U","U","V","Y","Z"
+};
+
 // Tek sütunlu alanlar (oturum vb.)
 static std::string detectSingleColumn(const cv::Mat& roiGray,
                                       int rows,
-                                      double fillThreshold) {
-    cv::Mat thr = preprocessForFill(roiGray);
+                                      double fillThreshold,
+                                      double scale) {
+    cv::Mat thr = preprocessForFill(roiGray, scale);
 
     int cellH = roiGray.rows / rows;
     int cellW = roiGray.cols;
@@ -208,6 +211,23 @@ static std::string detectSingleColumn(const cv::Mat& roiGray,
     return std::to_string(bestIdx);
 }
 
+// Ders gridlerinde satır başına seçilen şık (drawBubbleDebug ile aynı kural)
+void tracePicks(const std::vector<BubbleResult>& bubbles, core::RegionTrace& rt) {
+    for (int r = 0; r < static_cast<int>(bubbles.size()) && r < static_cast<int>(rt.picks.size()); ++r) {
+        const BubbleResult& b = bubbles[r];
+        if (!b.isValid || b.markedAnswer.empty()) continue;
+        const char m = b.markedAnswer[0];
+        const int idx = (m >= 'A') ? m - 'A' : m - '0';
+        if (idx >= 0 && idx < rt.cols) rt.picks[r] = static_cast<int16_t>(idx);
+    }
+}
+
+void traceScores(const std::vector<std::vector<double>>& ratios, core::RegionTrace& rt) {
+    for (int r = 0; r < static_cast<int>(ratios.size()) && r < rt.rows; ++r)
+        for (int c = 0; c < static_cast<int>(ratios[r].size()) && c < rt.cols; ++c)
+            rt.scores[r * rt.cols + c] = static_cast<float>(ratios[r][c]);
+}
+
 } // namespace
 
 ROIDetector::ROIDetector()
@@ -215,58 +235,109 @@ ROIDetector::ROIDetector()
       bubbleDetector_(fillThreshold_),
       debugMode_(false) {
 
-    // ✅ TC: 10 satır (0..9) x 11 sütun (11 hane)
-    regions_.push_back({
-        "tc_kimlik",
-        {0.0065f, 0.283f, 0.271f, 0.172f},
-        10, 11, GRID
-    });
-
-    // ✅ Öğrenci No: 10 satır (0..9) x 10 sütun
-    regions_.push_back({
-        "ogrenci_no",
-        {0.287f, 0.283f, 0.123f, 0.172f},
-        10, 5, GRID
-    });
-
-    // ✅ Ad Soyad: 29 satır (A-Z) x 21 sütun
-    regions_.push_back({
-        "adi_soyadi",
-        {0.000f, 0.490f, 0.520f, 0.495f},
-        29, 21, GRID
-    });
-
+    // Füzyonda satır kararları bubblesToAnswerString ile aynı eşikle verilir
+    bubbleDetector_.setDecisionConfidence(kAnswerConfidence);
 
-    
-    regions_.push_back({ "turkce",    {0.525f, 0.263f, 0.125f, 0.345f}, 20, 4, GRID });
-    regions_.push_back({ "sosyal",    {0.640f, 0.263f, 0.125f, 0.345f}, 20, 4, GRID });
-    regions_.push_back({ "din",       {0.755f, 0.263f, 0.125f, 0.345f}, 20, 4, GRID });
-    regions_.push_back({ "ingilizce", {0.874f, 0.263f, 0.125f, 0.345f}, 20, 4, GRID });
-
-    // Matematik ve Fen (Aynı hizayı korur)
-    regions_.push_back({ "matematik", {0.641f, 0.640f, 0.125f, 0.345f}, 20, 4, GRID });
-    regions_.push_back({ "fen",       {0.757f, 0.640f, 0.125f, 0.345f}, 20, 4, GRID });
+    // Varsayılan form derleme zamanı tanımından kurulur (bkz. core::kStandardForm)
+    for (const auto& d : core::kStandardForm.regions) {
+        regions_.push_back({ d.name, {d.rect[0], d.rect[1], d.rect[2], d.rect[3]},
+                             d.rows, d.cols, d.grid ? GRID : COLUMN });
+    }
 }
 
 void ROIDetector::setFillThreshold(double threshold) {
     fillThreshold_ = threshold;
     bubbleDetector_.setFillThreshold(threshold);
+    resetTemporalState(); // Eşik değişti: eski kararlar geçersiz
+}
+
+cv::Mat ROIDetector::layoutSignature(cv::Size size) const {
+    cv::Mat sig = cv::Mat::zeros(size, CV_32F);
+    for (const auto& reg : regions_) {
+        cv::Rect r(static_cast<int>(reg.rectPct[0] * size.width),
+                   static_cast<int>(reg.rectPct[1] * size.height),
+                   std::max(1, static_cast<int>(reg.rectPct[2] * size.width)),
+                   std::max(1, static_cast<int>(reg.rectPct[3] * size.height)));
+        r &= cv::Rect(0, 0, size.width, size.height);
+        if (r.area() > 0) sig(r).setTo(1.0);
+    }
+    return sig;
+}
+
+void ROIDetector::setWarpScale(double scale) {
+    warpScale_ = (scale > 0.0) ? scale : 1.0;
+    bubbleDetector_.setKernelScale(warpScale_);
+    resetTemporalState();
+}
+
+cv::Size2f ROIDetector::minCellPitch() const {
+    float w = 1.f, h = 1.f;
+    for (const auto& reg : regions_) {
+        w = std::min(w, reg.rectPct[2] / std::max(1, reg.cols));
+        h = std::min(h, reg.rectPct[3] / std::max(1, reg.rows));
+    }
+    return cv::Size2f(w, h);
+}
+
+void ROIDetector::setTemporalFusion(bool enabled, int settleFrames) {
+    temporalFusion_ = enabled;
+    settleFrames_ = std::max(1, settleFrames);
+    bubbleDetector_.setTemporalSmoothing(enabled, settleFrames_);
+    fieldHistory_.clear();
+}
+
+void ROIDetector::resetTemporalState() {
+    bubbleDetector_.resetTemporalState();
+    fieldHistory_.clear();
+}
+
+bool ROIDetector::allRegionsSettled() const {
+    if (!temporalFusion_) return false;
+
+    for (const auto& reg : regions_) {
+        if (reg.type == GRID && isSubjectRegion(reg.name)) {
+            if (!bubbleDetector_.isRegionSettled(reg.name)) return false;
+        } else {
+            auto it = fieldHistory_.find(reg.name);
+            if (it == fieldHistory_.end() || it->second.stableFrames < settleFrames_) return false;
+        }
+    }
+    return true;
 }
 
 void ROIDetector::setDebugMode(bool enabled) {
     debugMode_ = enabled;
 }
 
-cv::Mat ROIDetector::getLastDebugVisualization() const {
-    if (lastDebugVis_.empty()) return cv::Mat();
-    return lastDebugVis_.clone();
-}
 
 bool ROIDetector::isSubjectRegion(const std::string& name) const {
-    static const std::set<std::string> subjects = {
-        "turkce", "sosyal", "din", "ingilizce", "matematik", "fen"
-    };
-    return subjects.find(name) != subjects.end();
+    return subjectNames_.find(name) != subjectNames_.end();
+}
+
+bool ROIDetector::matchesStandardForm() const {
+    const auto& form = core::kStandardForm.regions;
+    if (regions_.size() != form.size()) return false;
+
+    for (size_t i = 0; i < form.size(); ++i) {
+        const RegionDef& r = regions_[i];
+        const core::RegionDesc& d = form[i];
+        if (r.name != d.name || r.rows != d.rows || r.cols != d.cols ||
+            (r.type == GRID) != d.grid ||
+            isSubjectRegion(r.name) != (d.kind == core::FieldKind::Answers)) return false;
+        for (int k = 0; k < 4; ++k) {
+            if (r.rectPct[k] != d.rect[k]) return false;
+        }
+    }
+    return true;
+}
+
+void ROIDetector::setTemplate(const std::vector<RegionDef>& regions,
+                              const std::set<std::string>& subjects) {
+    regions_ = regions;
+    subjectNames_ = subjects;
+    standardForm_ = matchesStandardForm();
+    fieldHistory_.clear();
+    bubbleDetector_.resetTemporalState();
 }
 
 std::string ROIDetector::bubblesToAnswerString(const std::vector<BubbleResult>& results) const {
@@ -275,7 +346,7 @@ std::string ROIDetector::bubblesToAnswerString(const std::vector<BubbleResult>&
     // --- GÜNCELLEME BURADA ---
     // İstediğin gibi eşik değerini 60.0 yaptık.
     // Artık 60 puanın altındaki her şey "BOŞ" (-) sayılacak.
-    const double CONFIDENCE_THRESHOLD = 60.0; 
+    const double CONFIDENCE_THRESHOLD = kAnswerConfidence;
 
     for (size_t i = 0; i < results.size(); ++i) {
         char mark = '-'; 
@@ -309,436 +380,529 @@ std::string ROIDetector::bubblesToAnswerString(const std::vector<BubbleResult>&
     }
     return oss.str();
 }
-std::map<std::string, std::string>
-ROIDetector::process(const cv::Mat& warped, cv::Mat& debugOut) {
-    CV_Assert(!warped.empty());
-
-    cv::Mat gray;
-    if (warped.channels() == 3)
-        cv::cvtColor(warped, gray, cv::COLOR_BGR2GRAY);
-    else
-        gray = warped.clone();
-
-    if (warped.channels() == 3)
-        lastDebugVis_ = warped.clone();
-    else
-        cv::cvtColor(warped, lastDebugVis_, cv::COLOR_GRAY2BGR);
-
-    std::map<std::string, std::string> out;
-
-    // ✅ ID alanları için ayrı threshold (cevap bubble'ından bağımsız)
-    // Daha yüksek threshold kullan ki gürültü kabul edilmesin
-    double idThr = std::clamp(fillThreshold_ * 1.2, 0.25, 0.45);
-
-    for (const auto& reg : regions_) {
-        cv::Rect roi = rectPct(gray, reg.rectPct[0], reg.rectPct[1],
-                               reg.rectPct[2], reg.rectPct[3]);
-
-        // GRID bölgelerinde border gürültüsünü azalt
-        if (reg.type == GRID) {
-            int dx = std::max(1, static_cast<int>(roi.width * 0.02));
-            int dy = std::max(1, static_cast<int>(roi.height * 0.02));
-            roi = cv::Rect(roi.x + dx, roi.y + dy,
-                           std::max(1, roi.width - 2 * dx),
-                           std::max(1, roi.height - 2 * dy));
-        }
-
-        if (isSubjectRegion(reg.name)) {
-            // TÜM DERSLER İÇİN TEK KURAL:
-            // 1. Koordinatlar (0.525 vb.) soru numarasının başladığı yerdir.
-            // 2. Biz bu alanın solundan %17'lik kısmı (numaraları) atlayacağız.
-            // 3. Sağ taraftan da taşma olmaması için genişliği limitleyeceğiz.
-
-            double questionOffsetRatio = 0.19; // Soru numaralarını atlama payı
-            double widthScaleFactor = 0.95;    // Baloncuk alanını netleştirmek için sağdan kırpma
-
-            int originalW = roi.width;
-            
-            // Soru numaralarını geçmek için X ekseninde öteleme
-            int offsetX = static_cast<int>(originalW * questionOffsetRatio);
-            
-            // Yeni genişlik hesabı (Ofseti düş, sağdan da biraz daralt)
-            int targetTotalW = static_cast<int>(originalW * widthScaleFactor);
-            int newWidth = std::max(1, targetTotalW - offsetX);
 
-            // ROI'yi güncelle
-            roi.x += offsetX;
-            roi.width = newWidth;
-        }
-
-        roi &= cv::Rect(0, 0, gray.cols, gray.rows);
-        if (roi.width <= 0 || roi.height <= 0) continue;
+template <bool Debug>
+bool ROIDetector::decodeRegion(const cv::Mat& gray, const RegionDef& reg,
+                               double idThr, std::string& val, core::RegionTrace* trace) {
+    // Kenar kırpması + ders alanlarında soru numaralarını atlama (derleme zamanı çekirdekleriyle ortak)
+    const cv::Rect roi = core::regionRoi(reg.rectPct, reg.type == GRID, isSubjectRegion(reg.name),
+                                         gray.cols, gray.rows).rect();
+    if (roi.width <= 0 || roi.height <= 0) return false;
+
+    const bool subjectGrid = (reg.type == GRID && isSubjectRegion(reg.name));
+
+    if constexpr (Debug) {
+        trace->name = reg.name;
+        trace->roi = roi;
+        trace->rows = reg.rows;
+        trace->cols = reg.cols;
+        trace->columnPicks = !subjectGrid;
+        trace->scores.assign(static_cast<size_t>(reg.rows) * reg.cols, 0.f);
+        trace->picks.assign(subjectGrid ? reg.rows : reg.cols, -1);
+    }
 
-        cv::Mat sub = gray(roi).clone();
-        std::string val;
+    // Çekirdekler referans warp boyutunda ayarlandı; küçük warp'ta orantılı küçülür
+    auto ks = [this](int base) { return core::scaledKernel(base, warpScale_); };
+    auto ms = [this](int base) { return core::scaledKernel(base, warpScale_, false); };
 
-        // ✅ Ders alanları: contour tabanlı bubble detector (sarı/yellow seçim)
-        if (reg.type == GRID && isSubjectRegion(reg.name)) {
-            
-            auto bubbles = bubbleDetector_.detectBubblesWithContours(sub, reg.rows, reg.cols, 1, 'A');
+    // Temporal füzyon: kararı oturmuş bölgeler tekrar decode edilmez
+    if (temporalFusion_) {
+        if (subjectGrid && bubbleDetector_.isRegionSettled(reg.name)) {
+            // Skorlar kararı veren EMA'dan: cellScores() / iz oturmuş bölgeyi de içerir
+            const auto& bubbles = bubbleDetector_.settledResults(reg.name);
+            const auto& ratios = bubbleDetector_.settledRatios(reg.name);
             val = bubblesToAnswerString(bubbles);
-
-            if (debugMode_) {
-                bubbleDetector_.drawBubbleDebug(lastDebugVis_, roi, bubbles, reg.rows, reg.cols, reg.name);
+            if (captureScores_) storeCellScores(reg.name, ratios);
+            if constexpr (Debug) {
+                traceScores(ratios, *trace);
+                tracePicks(bubbles, *trace);
             }
+            return true;
         }
-        // ✅ TC: sütun bazlı digit, ilk satır atla
-        else if (reg.name == "tc_kimlik") { // SADECE TC_KIMLIK İÇİN
-            
-            std::string resultString = "";
-            int rows = reg.rows; // 10 (0-9)
-            int cols = reg.cols; // 11 (Haneler)
-            
-            int cellW = sub.cols / cols;
-            int cellH = sub.rows / rows;
+        auto it = fieldHistory_.find(reg.name);
+        if (!subjectGrid && it != fieldHistory_.end() && it->second.stableFrames >= settleFrames_) {
+            val = it->second.value;
+            return true;
+        }
+    }
 
-            cv::Mat workingImg = sub.clone();
+    cv::Mat sub;
+    if (scoringMode_ == SCORE_THRESHOLD) sub = gray(roi).clone();
+    val.clear();
 
-            // 1. Yumuşatma
-            cv::GaussianBlur(workingImg, workingImg, cv::Size(5, 5), 0);
-            
-            // 2. YÖNTEM A: ADAPTIVE (Detaycı)
-            cv::Mat adaptiveBin;
-            cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
-                                  cv::ADAPTIVE_THRESH_GAUSSIAN_C,
-                                  cv::THRESH_BINARY_INV,
-                                  21, 15); 
-
-            // 3. YÖNTEM B: GLOBAL MASK (Kesin Filtre)
-            cv::Mat globalBin;
-            cv::threshold(workingImg, globalBin, 160, 255, cv::THRESH_BINARY_INV);
-
-            // 4. KESİŞİM (AND) - GÜRÜLTÜYÜ SİL
-            cv::Mat finalBin;
-            cv::bitwise_and(adaptiveBin, globalBin, finalBin);
+    // Karanlık skoru: sayfa başına hazırlanan harita üzerinden, bölge başına eşikleme yok
+    if (scoringMode_ == SCORE_DARKNESS) {
+        val = decodeRegionDarkness<Debug>(reg, roi, subjectGrid, trace);
+    }
+    // ✅ Ders alanları: contour tabanlı bubble detector (sarı/yellow seçim)
+    else if (subjectGrid) {
+        
+        // Füzyon kapalıysa tek kare okumasıdır
+        std::vector<std::vector<double>> ratios;
+        const bool wantRatios = Debug || captureScores_;
+        auto bubbles = bubbleDetector_.detectBubblesFused(sub, reg.rows, reg.cols, reg.name, 1, 'A',
+                                                          wantRatios ? &ratios : nullptr);
+        val = bubblesToAnswerString(bubbles);
+        if (captureScores_) storeCellScores(reg.name, ratios);
+
+        if constexpr (Debug) {
+            traceScores(ratios, *trace);
+            tracePicks(bubbles, *trace);
+        }
+    }
+    // ✅ TC: sütun bazlı digit, ilk satır atla
+    else if (reg.name == "tc_kimlik") { // SADECE TC_KIMLIK İÇİN
+        
+        std::string resultString = "";
+        int rows = reg.rows; // 10 (0-9)
+        int cols = reg.cols; // 11 (Haneler)
+        
+        int cellW = sub.cols / cols;
+        int cellH = sub.rows / rows;
+
+        cv::Mat workingImg = sub.clone();
+
+        // 1. Yumuşatma
+        cv::GaussianBlur(workingImg, workingImg, cv::Size(ks(5), ks(5)), 0);
+        
+        // 2. YÖNTEM A: ADAPTIVE (Detaycı)
+        cv::Mat adaptiveBin;
+        cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
+                              cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+                              cv::THRESH_BINARY_INV,
+                              ks(21), 15); 
+
+        // 3. YÖNTEM B: GLOBAL MASK (Kesin Filtre)
+        cv::Mat globalBin;
+        cv::threshold(workingImg, globalBin, 160, 255, cv::THRESH_BINARY_INV);
+
+        // 4. KESİŞİM (AND) - GÜRÜLTÜYÜ SİL
+        cv::Mat finalBin;
+        cv::bitwise_and(adaptiveBin, globalBin, finalBin);
+        
+        // 5. TEMİZLİK (Çizgileri kopar)
+        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(ms(3), ms(3)));
+        cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel);
+
+        // --- SÜTUNLARI GEZ ---
+        for (int c = 0; c < cols; ++c) {
             
-            // 5. TEMİZLİK (Çizgileri kopar)
-            cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
-            cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel);
+            double bestVal = 0.0;
+            int bestRow = -1;
 
-            // --- SÜTUNLARI GEZ ---
-            for (int c = 0; c < cols; ++c) {
+            // --- SATIRLARI GEZ ---
+            for (int r = 0; r < rows; ++r) {
                 
-                double bestVal = 0.0;
-                int bestRow = -1;
-
-                // --- SATIRLARI GEZ ---
-                for (int r = 0; r < rows; ++r) {
-                    
-                    // Kenar paylarını biraz artırdık (%30)
-                    int marginX = static_cast<int>(cellW * 0.30);
-                    int marginY = static_cast<int>(cellH * 0.30);
-                    
-                    cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
-                                  cellW - 2*marginX, cellH - 2*marginY);
-                    
-                    cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
-                    if (cell.width <= 0 || cell.height <= 0) continue;
-
-                    cv::Mat binCell = finalBin(cell);
-                    
-                    double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
-
-                    if (ratio > bestVal) {
-                        bestVal = ratio;
-                        bestRow = r;
-                    }
-
-                    // --- DEBUG: GRİ YUVARLAKLAR + YEŞİL PUAN ---
-                    if (debugMode_) {
-                        int centerX = roi.x + (c * cellW) + (cellW / 2);
-                        int centerY = roi.y + (r * cellH) + (cellH / 2);
-                        int radius = std::min(cellW, cellH) * 0.35;
-
-                        // Gri Daire
-                        cv::circle(lastDebugVis_, cv::Point(centerX, centerY), radius, 
-                                   cv::Scalar(100, 100, 100), 1, cv::LINE_AA);
-                        
-                        // YEŞİL/BÜYÜK PUAN
-                        if (ratio > 0.05) {
-                            std::string scoreTxt = std::to_string((int)(ratio * 100));
-                            cv::putText(lastDebugVis_, scoreTxt,
-                                       cv::Point(centerX - 10, centerY + 5), 
-                                       cv::FONT_HERSHEY_DUPLEX, 0.40, cv::Scalar(0, 255, 0), 1);
-                        }
-                    }
-                }
+                // Kenar paylarını biraz artırdık (%30)
+                int marginX = static_cast<int>(cellW * 0.30);
+                int marginY = static_cast<int>(cellH * 0.30);
+                
+                cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
+                              cellW - 2*marginX, cellH - 2*marginY);
+                
+                cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
+                if (cell.width <= 0 || cell.height <= 0) continue;
 
-                // --- KARAR ---
-                // Temizlenmiş resimde güvenli eşik: 0.30.
-                double THRESHOLD = 0.30; 
-                char detectedChar = '-'; 
+                cv::Mat binCell = finalBin(cell);
                 
-                if (bestVal > THRESHOLD && bestRow != -1) {
-                    detectedChar = '0' + bestRow;
-
-                    if (debugMode_) {
-                        cv::Rect finalCell(roi.x + c * cellW, roi.y + bestRow * cellH, cellW, cellH);
-                        
-                        // Seçilen Kare
-                        cv::rectangle(lastDebugVis_, finalCell, cv::Scalar(0, 255, 0), 2);
-                        
-                        // Rakamı Yaz
-                        std::string charTxt(1, detectedChar);
-                        cv::putText(lastDebugVis_, charTxt,
-                                   cv::Point(finalCell.x + 5, finalCell.y + finalCell.height - 5),
-                                   cv::FONT_HERSHEY_SIMPLEX, 0.50, cv::Scalar(0, 255, 0), 2);
-                    }
+                double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
+
+                if (ratio > bestVal) {
+                    bestVal = ratio;
+                    bestRow = r;
                 }
-                
-                resultString += detectedChar;
-            }
-            
-            val = resultString;
-        }
-        else if (reg.name == "ogrenci_no") { 
-            
-            std::string resultString = "";
-            int rows = reg.rows; // 10 (0-9)
-            int cols = reg.cols; // 5 (Haneler)
-            
-            int cellW = sub.cols / cols;
-            int cellH = sub.rows / rows;
 
-            cv::Mat workingImg = sub.clone();
+                if constexpr (Debug) trace->scores[r * cols + c] = static_cast<float>(ratio);
+            }
 
-            // 1. Yumuşatma (Gürültüyü azalt)
-            cv::GaussianBlur(workingImg, workingImg, cv::Size(7, 7), 0);
+            // --- KARAR ---
+            // Temizlenmiş resimde güvenli eşik: 0.30.
+            double THRESHOLD = 0.30; 
+            char detectedChar = '-'; 
             
-            // 2. YÖNTEM A: ADAPTIVE (Daha seçici)
-            cv::Mat adaptiveBin;
-            cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
-                                  cv::ADAPTIVE_THRESH_GAUSSIAN_C,
-                                  cv::THRESH_BINARY_INV,
-                                  25, 20); // Kritik ayarlar
-
-            // 3. YÖNTEM B: GLOBAL MASK (Katı Filtre)
-            cv::Mat globalBin;
-            cv::threshold(workingImg, globalBin, 180, 255, cv::THRESH_BINARY_INV);
-
-            // 4. KESİŞİM (AND) - GÜRÜLTÜYÜ SİL
-            cv::Mat finalBin;
-            cv::bitwise_and(adaptiveBin, globalBin, finalBin);
+            if (bestVal > THRESHOLD && bestRow != -1) {
+                detectedChar = '0' + bestRow;
+                if constexpr (Debug) trace->picks[c] = static_cast<int16_t>(bestRow);
+            }
             
-            // 5. TEMİZLİK (Çizgileri kopar - Morphological Open)
-            cv::Mat kernel_morph = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
-            cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel_morph);
-
-            // 6. TEKRAR EROSION (Ek Aşındırma)
-            cv::Mat kernel_erode = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2, 2));
-            cv::erode(finalBin, finalBin, kernel_erode, cv::Point(-1, -1), 1);
+            resultString += detectedChar;
+        }
+        
+        val = resultString;
+    }
+    else if (reg.name == "ogrenci_no") { 
+        
+        std::string resultString = "";
+        int rows = reg.rows; // 10 (0-9)
+        int cols = reg.cols; // 5 (Haneler)
+        
+        int cellW = sub.cols / cols;
+        int cellH = sub.rows / rows;
+
+        cv::Mat workingImg = sub.clone();
+
+        // 1. Yumuşatma (Gürültüyü azalt)
+        cv::GaussianBlur(workingImg, workingImg, cv::Size(ks(7), ks(7)), 0);
+        
+        // 2. YÖNTEM A: ADAPTIVE (Daha seçici)
+        cv::Mat adaptiveBin;
+        cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
+                              cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+                              cv::THRESH_BINARY_INV,
+                              ks(25), 20); // Kritik ayarlar
+
+        // 3. YÖNTEM B: GLOBAL MASK (Katı Filtre)
+        cv::Mat globalBin;
+        cv::threshold(workingImg, globalBin, 180, 255, cv::THRESH_BINARY_INV);
+
+        // 4. KESİŞİM (AND) - GÜRÜLTÜYÜ SİL
+        cv::Mat finalBin;
+        cv::bitwise_and(adaptiveBin, globalBin, finalBin);
+        
+        // 5. TEMİZLİK (Çizgileri kopar - Morphological Open)
+        cv::Mat kernel_morph = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(ms(3), ms(3)));
+        cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel_morph);
+
+        // 6. TEKRAR EROSION (Ek Aşındırma)
+        cv::Mat kernel_erode = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(ms(2), ms(2)));
+        cv::erode(finalBin, finalBin, kernel_erode, cv::Point(-1, -1), 1);
+
+        // --- SÜTUNLARI GEZ ---
+        for (int c = 0; c < cols; ++c) {
+            
+            double bestVal = 0.0;
+            int bestRow = -1;
 
-            // --- SÜTUNLARI GEZ ---
-            for (int c = 0; c < cols; ++c) {
+            // --- SATIRLARI GEZ ---
+            for (int r = 0; r < rows; ++r) {
                 
-                double bestVal = 0.0;
-                int bestRow = -1;
-
-                // --- SATIRLARI GEZ ---
-                for (int r = 0; r < rows; ++r) {
-                    
-                    // Kenar paylarını artırdık (%30)
-                    int marginX = static_cast<int>(cellW * 0.30);
-                    int marginY = static_cast<int>(cellH * 0.30);
-                    
-                    cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
-                                  cellW - 2*marginX, cellH - 2*marginY);
-                    
-                    cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
-                    if (cell.width <= 0 || cell.height <= 0) continue;
-
-                    cv::Mat binCell = finalBin(cell);
-                    
-                    double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
-
-                    if (ratio > bestVal) {
-                        bestVal = ratio;
-                        bestRow = r;
-                    }
-
-                    // --- DEBUG: GRİ YUVARLAKLAR + YEŞİL PUAN ---
-                    if (debugMode_) {
-                        int centerX = roi.x + (c * cellW) + (cellW / 2);
-                        int centerY = roi.y + (r * cellH) + (cellH / 2);
-                        int radius = std::min(cellW, cellH) * 0.35;
-
-                        // Gri Daire
-                        cv::circle(lastDebugVis_, cv::Point(centerX, centerY), radius, 
-                                   cv::Scalar(100, 100, 100), 1, cv::LINE_AA);
-                        
-                        // YEŞİL/BÜYÜK PUAN (Sadece kayda değer doluluk varsa yaz)
-                        if (ratio > 0.05) {
-                            std::string scoreTxt = std::to_string((int)(ratio * 100));
-                            cv::putText(lastDebugVis_, scoreTxt,
-                                       cv::Point(centerX - 10, centerY + 5), 
-                                       cv::FONT_HERSHEY_DUPLEX, 0.40, cv::Scalar(0, 255, 0), 1);
-                        }
-                    }
-                }
+                // Kenar paylarını artırdık (%30)
+                int marginX = static_cast<int>(cellW * 0.30);
+                int marginY = static_cast<int>(cellH * 0.30);
+                
+                cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
+                              cellW - 2*marginX, cellH - 2*marginY);
+                
+                cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
+                if (cell.width <= 0 || cell.height <= 0) continue;
 
-                // --- KARAR ---
-                // Eşik değeri 0.20 olarak kalıyor. Bu, temizlenmiş resimde güvenilir bir değerdir.
-                double THRESHOLD = 0.10; 
-                char detectedChar = '-'; 
+                cv::Mat binCell = finalBin(cell);
                 
-                if (bestVal > THRESHOLD && bestRow != -1) {
-                    detectedChar = '0' + bestRow;
-
-                    if (debugMode_) {
-                        cv::Rect finalCell(roi.x + c * cellW, roi.y + bestRow * cellH, cellW, cellH);
-                        
-                        // Seçilen Kare
-                        cv::rectangle(lastDebugVis_, finalCell, cv::Scalar(0, 255, 0), 2);
-                        
-                        // Rakamı Yaz
-                        std::string charTxt(1, detectedChar);
-                        cv::putText(lastDebugVis_, charTxt,
-                                   cv::Point(finalCell.x + 5, finalCell.y + finalCell.height - 5),
-                                   cv::FONT_HERSHEY_SIMPLEX, 0.50, cv::Scalar(0, 255, 0), 2);
-                    }
+                double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
+
+                if (ratio > bestVal) {
+                    bestVal = ratio;
+                    bestRow = r;
                 }
-                
-                resultString += detectedChar;
+
+                if constexpr (Debug) trace->scores[r * cols + c] = static_cast<float>(ratio);
             }
-            
-            val = resultString;
-        }
 
-        else if (reg.name == "adi_soyadi") {
+            // --- KARAR ---
+            // Eşik değeri 0.20 olarak kalıyor. Bu, temizlenmiş resimde güvenilir bir değerdir.
+            double THRESHOLD = 0.10; 
+            char detectedChar = '-'; 
             
-            std::vector<std::string> TR_CHARS = {
-                "A","B","C","C","D","E","F","G","G","H","I","I","J","K","L","M",
-                "N","O","O","P","R","S","S","T","U","U","V","Y","Z"
-            };
-
-            std::string resultString = "";
-            int rows = reg.rows; 
-            int cols = reg.cols; 
+            if (bestVal > THRESHOLD && bestRow != -1) {
+                detectedChar = '0' + bestRow;
+                if constexpr (Debug) trace->picks[c] = static_cast<int16_t>(bestRow);
+            }
             
-            int cellW = sub.cols / cols;
-            int cellH = sub.rows / rows;
+            resultString += detectedChar;
+        }
+        
+        val = resultString;
+    }
 
-            cv::Mat workingImg = sub.clone();
+    else if (reg.name == "adi_soyadi") {
+        
+        const std::vector<std::string>& TR_CHARS = kNameAlphabet;
+
+        std::string resultString = "";
+        int rows = reg.rows; 
+        int cols = reg.cols; 
+        
+        int cellW = sub.cols / cols;
+        int cellH = sub.rows / rows;
+
+        cv::Mat workingImg = sub.clone();
+        
+        // 1. Yumuşatma
+        cv::GaussianBlur(workingImg, workingImg, cv::Size(ks(5), ks(5)), 0);
+
+        // 2. YÖNTEM A: ADAPTIVE (Detaycı)
+        // G satırını ve silik işaretleri yakalar.
+        // C değerini 25 yaptık (Daha seçici olsun diye).
+        cv::Mat adaptiveBin;
+        cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
+                              cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+                              cv::THRESH_BINARY_INV,
+                              ks(31), 25);
+
+        // 3. YÖNTEM B: GLOBAL MASK (Filtre)
+        // Kağıdın boş yerlerini (beyaz/açık gri) kesinlikle eler.
+        // 160 değeri: 255(Beyaz) ile 0(Siyah) arasında orta-açık gri bir sınırdır.
+        // Bunun üzerindeki (daha beyaz) her şeyi yok sayar.
+        cv::Mat globalBin;
+        cv::threshold(workingImg, globalBin, 160, 255, cv::THRESH_BINARY_INV);
+
+        // 4. KESİŞİM (AND) - SİHİRLİ DOKUNUŞ
+        // Bir pikselin işaret sayılması için HEM Adaptive (çevresinden koyu)
+        // HEM DE Global (gerçekten koyu) olması gerekir.
+        // Bu işlem boş sütunlardaki gürültüyü %100 temizler.
+        cv::Mat finalBin;
+        cv::bitwise_and(adaptiveBin, globalBin, finalBin);
+
+        // 5. TEMİZLİK (Çizgileri kopar)
+        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(ms(3), ms(3)));
+        cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel);
+
+        // --- SÜTUNLARI GEZ ---
+        for (int c = 0; c < cols; ++c) {
             
-            // 1. Yumuşatma
-            cv::GaussianBlur(workingImg, workingImg, cv::Size(5, 5), 0);
-
-            // 2. YÖNTEM A: ADAPTIVE (Detaycı)
-            // G satırını ve silik işaretleri yakalar.
-            // C değerini 25 yaptık (Daha seçici olsun diye).
-            cv::Mat adaptiveBin;
-            cv::adaptiveThreshold(workingImg, adaptiveBin, 255,
-                                  cv::ADAPTIVE_THRESH_GAUSSIAN_C,
-                                  cv::THRESH_BINARY_INV,
-                                  31, 25);
-
-            // 3. YÖNTEM B: GLOBAL MASK (Filtre)
-            // Kağıdın boş yerlerini (beyaz/açık gri) kesinlikle eler.
-            // 160 değeri: 255(Beyaz) ile 0(Siyah) arasında orta-açık gri bir sınırdır.
-            // Bunun üzerindeki (daha beyaz) her şeyi yok sayar.
-            cv::Mat globalBin;
-            cv::threshold(workingImg, globalBin, 160, 255, cv::THRESH_BINARY_INV);
-
-            // 4. KESİŞİM (AND) - SİHİRLİ DOKUNUŞ
-            // Bir pikselin işaret sayılması için HEM Adaptive (çevresinden koyu)
-            // HEM DE Global (gerçekten koyu) olması gerekir.
-            // Bu işlem boş sütunlardaki gürültüyü %100 temizler.
-            cv::Mat finalBin;
-            cv::bitwise_and(adaptiveBin, globalBin, finalBin);
-
-            // 5. TEMİZLİK (Çizgileri kopar)
-            cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
-            cv::morphologyEx(finalBin, finalBin, cv::MORPH_OPEN, kernel);
-
-            // --- SÜTUNLARI GEZ ---
-            for (int c = 0; c < cols; ++c) {
+            double bestVal = 0.0;
+            int bestRow = -1;
+
+            // --- SATIRLARI GEZ ---
+            for (int r = 0; r < rows; ++r) {
                 
-                double bestVal = 0.0;
-                int bestRow = -1;
-
-                // --- SATIRLARI GEZ ---
-                for (int r = 0; r < rows; ++r) {
-                    
-                    int marginX = static_cast<int>(cellW * 0.30);
-                    int marginY = static_cast<int>(cellH * 0.30);
-                    
-                    cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
-                                  cellW - 2*marginX, cellH - 2*marginY);
-                    
-                    cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
-                    if (cell.width <= 0 || cell.height <= 0) continue;
-
-                    cv::Mat binCell = finalBin(cell);
-                    
-                    double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
-
-                    if (ratio > bestVal) {
-                        bestVal = ratio;
-                        bestRow = r;
-                    }
-
-                    // DEBUG: Gri Daire + Yeşil Puan
-                    if (debugMode_) {
-                        int centerX = roi.x + (c * cellW) + (cellW / 2);
-                        int centerY = roi.y + (r * cellH) + (cellH / 2);
-                        int radius = std::min(cellW, cellH) * 0.35;
-
-                        cv::circle(lastDebugVis_, cv::Point(centerX, centerY), radius, 
-                                   cv::Scalar(100, 100, 100), 1, cv::LINE_AA);
-                        
-                        if (ratio > 0.05) { // Sadece %5 üstü doluluk varsa yaz
-                            std::string scoreTxt = std::to_string((int)(ratio * 100));
-                            cv::putText(lastDebugVis_, scoreTxt,
-                                       cv::Point(centerX - 10, centerY + 5), 
-                                       cv::FONT_HERSHEY_DUPLEX, 0.40, cv::Scalar(0, 255, 0), 1);
-                        }
-                    }
-                }
+                int marginX = static_cast<int>(cellW * 0.30);
+                int marginY = static_cast<int>(cellH * 0.30);
+                
+                cv::Rect cell(c * cellW + marginX, r * cellH + marginY, 
+                              cellW - 2*marginX, cellH - 2*marginY);
+                
+                cell &= cv::Rect(0, 0, finalBin.cols, finalBin.rows);
+                if (cell.width <= 0 || cell.height <= 0) continue;
 
-                // --- KARAR ---
-                // Melez yöntem sayesinde boş yerler tertemiz (0 puan) çıkar.
-                // Gerçek işaretler ise 30-70 arası çıkar.
-                // Eşiği 0.20 (%20) yapmak çok güvenlidir.
-                double THRESHOLD = 0.40; 
-                std::string detectedChar = " "; 
+                cv::Mat binCell = finalBin(cell);
                 
-                if (bestVal > THRESHOLD && bestRow != -1 && bestRow < (int)TR_CHARS.size()) {
-                    detectedChar = TR_CHARS[bestRow];
-
-                    if (debugMode_) {
-                        cv::Rect finalCell(roi.x + c * cellW, roi.y + bestRow * cellH, cellW, cellH);
-                        cv::rectangle(lastDebugVis_, finalCell, cv::Scalar(0, 255, 0), 2);
-                        cv::putText(lastDebugVis_, detectedChar,
-                                   cv::Point(finalCell.x + 5, finalCell.y + finalCell.height - 5),
-                                   cv::FONT_HERSHEY_SIMPLEX, 0.50, cv::Scalar(0, 255, 0), 2);
-                    }
+                double ratio = (double)cv::countNonZero(binCell) / (cell.width * cell.height);
+
+                if (ratio > bestVal) {
+                    bestVal = ratio;
+                    bestRow = r;
                 }
-                
-                resultString += detectedChar;
+
+                if constexpr (Debug) trace->scores[r * cols + c] = static_cast<float>(ratio);
             }
+
+            // --- KARAR ---
+            // Melez yöntem sayesinde boş yerler tertemiz (0 puan) çıkar.
+            // Gerçek işaretler ise 30-70 arası çıkar.
+            // Eşiği 0.20 (%20) yapmak çok güvenlidir.
+            double THRESHOLD = 0.40; 
+            std::string detectedChar = " "; 
             
-            // Sağdaki boşlukları (trailing spaces) temizle
-            // Örneğin "AHMET YUNUS      " -> "AHMET YUNUS"
-            size_t lastChar = resultString.find_last_not_of(' ');
-            if (lastChar != std::string::npos) {
-                resultString = resultString.substr(0, lastChar + 1);
-            } else {
-                resultString = ""; // Tamamen boşsa
+            if (bestVal > THRESHOLD && bestRow != -1 && bestRow < (int)TR_CHARS.size()) {
+                detectedChar = TR_CHARS[bestRow];
+                if constexpr (Debug) trace->picks[c] = static_cast<int16_t>(bestRow);
             }
+            
+            resultString += detectedChar;
+        }
+        
+        // Sağdaki boşlukları (trailing spaces) temizle
+        // Örneğin "AHMET YUNUS      " -> "AHMET YUNUS"
+        size_t lastChar = resultString.find_last_not_of(' ');
+        if (lastChar != std::string::npos) {
+            resultString = resultString.substr(0, lastChar + 1);
+        } else {
+            resultString = ""; // Tamamen boşsa
+        }
+
+        val = resultString;
+    }
+    else {
+        val = detectSingleColumn(sub, reg.rows, idThr, warpScale_);
+    }
+
+    // Kimlik / tek sütun alanları: aynı metin settleFrames_ kare okununca oturur
+    if (temporalFusion_ && !subjectGrid) {
+        auto& fh = fieldHistory_[reg.name];
+        if (fh.value == val) fh.stableFrames++;
+        else { fh.value = val; fh.stableFrames = 1; }
+    }
+
+    return true;
+}
 
-            val = resultString;
+template <bool Debug>
+std::string ROIDetector::decodeRegionDarkness(const RegionDef& reg, const cv::Rect& roi,
+                                              bool subjectGrid, core::RegionTrace* trace) {
+    // Standart form + bilinen warp boyutunda hücre adresleri derleme zamanı tablosundan okunur
+    std::vector<std::vector<double>> scores;
+    const size_t index = static_cast<size_t>(&reg - regions_.data());
+    if (!fixedKernel_ || !fixedKernel_->scoreRegion(index, darkness_, scores))
+        darkness_.scoreGrid(roi, reg.rows, reg.cols, scores);
+
+    if (captureScores_ && subjectGrid) storeCellScores(reg.name, scores);
+    if constexpr (Debug) traceScores(scores, *trace);
+
+    if (subjectGrid) {
+        auto bubbles = bubbleDetector_.detectFromRatios(scores, reg.name, 1, 'A');
+        if constexpr (Debug) tracePicks(bubbles, *trace);
+        return bubblesToAnswerString(bubbles);
+    }
+
+    // Kimlik alanları: sütun başına en karanlık satır, ders alanlarıyla aynı tek eşik
+    const double thr = kAnswerConfidence / 100.0;
+    const bool nameField = (reg.name == "adi_soyadi");
+
+    std::string out;
+    for (int c = 0; c < reg.cols; ++c) {
+        int bestRow = -1;
+        double bestVal = 0.0;
+        for (int r = 0; r < reg.rows; ++r) {
+            if (scores[r][c] > bestVal) { bestVal = scores[r][c]; bestRow = r; }
         }
-        else {
-            val = detectSingleColumn(sub, reg.rows, idThr);
+        const bool marked = bestRow >= 0 && bestVal >= thr;
+
+        if (nameField) {
+            out += (marked && bestRow < (int)kNameAlphabet.size()) ? kNameAlphabet[bestRow] : " ";
+        } else if (reg.cols == 1) {
+            out += marked ? std::to_string(bestRow) : "-";
+        } else {
+            out += marked ? static_cast<char>('0' + bestRow) : '-';
         }
 
-        out[reg.name] = val;
+        if constexpr (Debug) {
+            if (marked) trace->picks[c] = static_cast<int16_t>(bestRow);
+        }
+    }
 
-        cv::rectangle(lastDebugVis_, roi, cv::Scalar(0, 255, 0), 2);
-        cv::putText(lastDebugVis_, reg.name, roi.tl() + cv::Point(4, 16),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 0, 255), 2);
+    if (nameField) {
+        size_t lastChar = out.find_last_not_of(' ');
+        out = (lastChar == std::string::npos) ? std::string() : out.substr(0, lastChar + 1);
     }
+    return out;
+}
+
+void ROIDetector::storeCellScores(const std::string& name,
+                                  const std::vector<std::vector<double>>& ratios) {
+    const int rows = static_cast<int>(ratios.size());
+    const int cols = rows > 0 ? static_cast<int>(ratios[0].size()) : 0;
+
+    // Dışarıda tutulan eski skorların üzerine yazılmasın diye her seferinde yeni tampon
+    cv::Mat m(rows, cols, CV_64F);
+    for (int r = 0; r < rows; ++r) std::copy(ratios[r].begin(), ratios[r].end(), m.ptr<double>(r));
+    cellScores_[name] = m;
+}
+
+void ROIDetector::setScoringMode(ScoringMode mode) {
+    // Çağıranın seçtiği mod ayrı tutulur: dropout kapanınca buna dönülür
+    requestedScoringMode_ = mode;
+    identitySource_.release();   // darkness_ artık ön okumanın haritası olmayabilir
+    identityGray_.release();
+    scoringMode_ = dropout_ ? SCORE_DARKNESS : mode;
+    if (scoringMode_ != SCORE_DARKNESS) darkness_.clear();
+    resetTemporalState();
+}
+
+void ROIDetector::setDropoutMode(bool enabled) {
+    dropout_ = enabled;
+
+    // Harf bölgesi düşük ağırlığı sadece basılı harfler görünürken anlamlıdır. Parametre
+    // değişince sabit yerleşim çekirdeği eşleşmez, çalışma zamanı skoru kullanılır (yine O(1)).
+    core::DarknessMap::Params p;
+    if (enabled) p.letterWeight = 1.0;
+    darkness_ = core::DarknessMap(p);
 
-    debugOut = lastDebugVis_.clone();
+    setScoringMode(requestedScoringMode_);
+}
+
+template <bool Debug>
+std::map<std::string, std::string> ROIDetector::decodeRegions(const cv::Mat& gray, bool identityOnly,
+                                                             const std::map<std::string, std::string>* known,
+                                                             bool darknessReady) {
+    std::map<std::string, std::string> out;
+    if (scoringMode_ == SCORE_DARKNESS && !darknessReady) darkness_.build(gray);
+    fixedKernel_ = (scoringMode_ == SCORE_DARKNESS && fixedLayout_ && standardForm_)
+                 ? core::standardFormKernel(gray.size()) : nullptr;
+
+    // ✅ ID alanları için ayrı threshold (cevap bubble'ından bağımsız)
+    // Daha yüksek threshold kullan ki gürültü kabul edilmesin
+    double idThr = std::clamp(fillThreshold_ * 1.2, 0.25, 0.45);
+
+    for (const auto& reg : regions_) {
+        if (identityOnly && reg.name != "tc_kimlik" && reg.name != "ogrenci_no") continue;
+        if (known) {
+            auto k = known->find(reg.name);
+            if (k != known->end()) {
+                out[reg.name] = k->second;
+                continue;
+            }
+        }
+
+        std::string val;
+        core::RegionTrace* rt = nullptr;
+        if constexpr (Debug) {
+            trace_.regions.emplace_back();
+            rt = &trace_.regions.back();
+        }
+        if (decodeRegion<Debug>(gray, reg, idThr, val, rt)) out[reg.name] = val;
+        else if constexpr (Debug) trace_.regions.pop_back();
+    }
     return out;
 }
+
+std::map<std::string, std::string>
+ROIDetector::process(const cv::Mat& warped) {
+    CV_Assert(!warped.empty());
+
+    cv::Mat gray;
+    if (warped.channels() == 3)
+        cv::cvtColor(warped, gray, cv::COLOR_BGR2GRAY);
+    else
+        gray = warped;
+
+    trace_.clear();
+    if (captureScores_) cellScores_.clear();
+    identitySource_.release();
+    identityGray_.release();
+
+    // Görsel burada üretilmez; debug modunda sadece iz tutulur (bkz. core::renderDecodeTrace)
+    return debugMode_ ? decodeRegions<true>(gray, false) : decodeRegions<false>(gray, false);
+}
+
+std::map<std::string, std::string>
+ROIDetector::process(const cv::Mat& warped, const std::map<std::string, std::string>& known) {
+    CV_Assert(!warped.empty());
+
+    // Aynı tampon: ön okumanın gri görüntüsü ve karanlık haritası geçerli
+    const bool sameSheet = !identitySource_.empty() && identitySource_.data == warped.data &&
+                           identitySource_.size() == warped.size() && identitySource_.type() == warped.type();
+
+    cv::Mat gray;
+    if (sameSheet) gray = identityGray_;
+    else if (warped.channels() == 3)
+        cv::cvtColor(warped, gray, cv::COLOR_BGR2GRAY);
+    else
+        gray = warped;
+
+    identitySource_.release();
+    identityGray_.release();
+    trace_.clear();
+    if (captureScores_) cellScores_.clear();
+
+    return debugMode_ ? decodeRegions<true>(gray, false, &known, sameSheet)
+                      : decodeRegions<false>(gray, false, &known, sameSheet);
+}
+
+std::map<std::string, std::string>
+ROIDetector::processIdentity(const cv::Mat& warped) {
+    CV_Assert(!warped.empty());
+
+    cv::Mat gray;
+    if (warped.channels() == 3)
+        cv::cvtColor(warped, gray, cv::COLOR_BGR2GRAY);
+    else
+        gray = warped;
+
+    // Devam okuması (process(warped, known)) aynı sayfayı tekrar hazırlamasın
+    identitySource_ = warped;
+    identityGray_ = gray;
+
+    // Sadece kimlik alanları; iz tutulmaz
+    return decodeRegions<false>(gray, true);
+}
@@ -0,0 +1,66 @@
+#include "core/SearchWindow.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace core {
+
+cv::Rect SearchWindow::next(cv::Size frameSize) {
+    const cv::Rect full(0, 0, frameSize.width, frameSize.height);
+
+    // Çözünürlük değiştiyse eski pencere geçersiz
+    if (frameSize != frameSize_) {
+        frameSize_ = frameSize;
+        locked_ = false;
+    }
+
+    fullFrame_ = !enabled_ || !locked_ ||
+                 (params_.sweepEvery > 0 && ++sinceSweep_ >= params_.sweepEvery);
+    if (fullFrame_) {
+        sinceSweep_ = 0;
+        return full;
+    }
+    return window_ & full;
+}
+
+void SearchWindow::update(bool found, const std::array<cv::Point2f, 4>& corners) {
+    if (!enabled_) return;
+
+    if (!found) {
+        // Tam taramada da yoksa kağıt gitmiştir; pencerede yoksa birkaç kare daha denenir
+        if (fullFrame_ || ++misses_ >= params_.maxMisses) reset();
+        return;
+    }
+    misses_ = 0;
+
+    std::vector<cv::Point2f> pts(corners.begin(), corners.end());
+    const cv::Rect bounds = cv::boundingRect(pts);
+
+    // Pencere sadece kilitlenirken, tam taramada veya köşeler kenara yaklaşınca yeniden kurulur
+    bool recenter = !locked_ || fullFrame_;
+    if (!recenter) {
+        const int guard = std::max(params_.minMarginPx / 2,
+                                   static_cast<int>(params_.margin * 0.5 * std::max(bounds.width, bounds.height)));
+        cv::Rect inner(window_.x + guard, window_.y + guard,
+                       window_.width - 2 * guard, window_.height - 2 * guard);
+        recenter = inner.width <= 0 || inner.height <= 0 || (bounds & inner) != bounds;
+    }
+
+    if (recenter) window_ = windowFor(bounds);
+    locked_ = true;
+}
+
+void SearchWindow::reset() {
+    locked_ = false;
+    misses_ = 0;
+    sinceSweep_ = 0;
+}
+
+cv::Rect SearchWindow::windowFor(const cv::Rect& bounds) const {
+    const int pad = std::max(params_.minMarginPx,
+                             static_cast<int>(std::lround(params_.margin * std::max(bounds.width, bounds.height))));
+    cv::Rect w(bounds.x - pad, bounds.y - pad, bounds.width + 2 * pad, bounds.height + 2 * pad);
+    return w & cv::Rect(0, 0, frameSize_.width, frameSize_.height);
+}
+
+}
@@ -0,0 +1,48 @@
+#include "core/SheetGrader.hpp"
+
+namespace core {
+
+SheetGrader::SheetGrader(const AnswerKey& key, const WarpProfile& profile, double fillThreshold)
+    : key_(key), pc_(profile.width, profile.height) {
+    pc_.setKernelScale(profile.scale);
+    detector_.setWarpScale(profile.scale);
+    detector_.setFillThreshold(fillThreshold);
+    detector_.setDebugMode(false);
+    pc_.setLayoutSignature(detector_.layoutSignature()); // Ters taranmış kağıtlar otomatik düzelir
+}
+
+bool SheetGrader::warp(const cv::Mat& image, cv::Mat& warped, bool* scanAligned) const {
+    if (image.empty()) return false;
+
+    auto R = scannerMode_ ? pc_.alignScan(image) : pc_.findAndWarp(image, false);
+    if (!R.ok || R.warped.empty()) return false;
+
+    warped = R.warped;
+    if (scanAligned) *scanAligned = R.scanAligned;
+    return true;
+}
+
+void SheetGrader::setTemplate(const std::vector<ROIDetector::RegionDef>& regions,
+                              const std::set<std::string>& subjects) {
+    detector_.setTemplate(regions, subjects);
+    pc_.setLayoutSignature(detector_.layoutSignature());
+}
+
+std::map<std::string, std::string> SheetGrader::readIdentity(const cv::Mat& warped) {
+    return detector_.processIdentity(warped);
+}
+
+std::map<std::string, std::string> SheetGrader::readAll(const cv::Mat& warped) {
+    return detector_.process(warped);
+}
+
+std::map<std::string, std::string> SheetGrader::readAll(const cv::Mat& warped,
+                                                        const std::map<std::string, std::string>& identity) {
+    return detector_.process(warped, identity);
+}
+
+AnswerKey::ScoreResult SheetGrader::score(const std::map<std::string, std::string>& answers) {
+    return key_.calculateScore(answers);
+}
+
+}
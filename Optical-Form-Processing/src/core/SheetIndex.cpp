@@ -0,0 +1,161 @@
+#include "core/SheetIndex.hpp"
+#include <algorithm>
+#include <bitset>
+#include <unordered_set>
+
+namespace core {
+
+namespace {
+
+// Parmak izi küçük resminin ölçeği (1600x2200 warp -> 100x137)
+constexpr int kThumbDiv = 16;
+
+// Aynı tarama sayılmak için izin verilen farklar.
+// Tek bir dolu bubble küçük resimde ~2-3 pikseli 60+ seviye koyulaştırır;
+// tarayıcı tekrarındaki alt-piksel kaymalar çizgi kenarlarında ~10-20 seviye fark üretir.
+constexpr int kMaxCoarseHamming = 10;
+constexpr double kMaxThumbDiff = 40.0;
+
+int hamming(uint64_t a, uint64_t b) {
+    return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
+
+// Hash bantları: 64 bit 6 banda (11,11,11,11,10,10 bit) bölünür. Hamming <= 10 olan iki
+// hash'ten en az bir bantta <= 1 bit farklıdır (6 bandın hepsi >= 2 farklı olsa toplam >= 12),
+// bu yüzden her bandın tam değeri + 1 bit komşuları yoklanınca hiçbir aday kaçmaz.
+constexpr int kBandCount = 6;
+static_assert(2 * kBandCount > kMaxCoarseHamming, "bant yoklamasi esik icindeki adaylari kacirir");
+
+int bandWidth(int b) {
+    return 64 / kBandCount + (b < 64 % kBandCount ? 1 : 0);
+}
+
+uint32_t bandValue(uint64_t h, int b) {
+    int shift = 0;
+    for (int i = 0; i < b; ++i) shift += bandWidth(i);
+    return static_cast<uint32_t>((h >> shift) & ((uint64_t(1) << bandWidth(b)) - 1));
+}
+
+} // namespace
+
+SheetFingerprint computeFingerprint(const cv::Mat& warpedGray) {
+    SheetFingerprint fp;
+    if (warpedGray.empty()) return fp;
+
+    cv::Mat gray;
+    if (warpedGray.channels() == 3) cv::cvtColor(warpedGray, gray, cv::COLOR_BGR2GRAY);
+    else gray = warpedGray;
+
+    cv::Size thumbSize(std::max(8, gray.cols / kThumbDiv), std::max(8, gray.rows / kThumbDiv));
+    cv::resize(gray, fp.thumb, thumbSize, 0, 0, cv::INTER_AREA);
+
+    // Aydınlatma / kontrast farklarını yok say
+    cv::normalize(fp.thumb, fp.thumb, 0, 255, cv::NORM_MINMAX);
+
+    cv::Mat tiny;
+    cv::resize(fp.thumb, tiny, cv::Size(8, 8), 0, 0, cv::INTER_AREA);
+    double m = cv::mean(tiny)[0];
+
+    for (int i = 0; i < 64; ++i) {
+        if (tiny.at<uchar>(i / 8, i % 8) > m) fp.coarse |= (uint64_t(1) << i);
+    }
+    return fp;
+}
+
+bool isSameScan(const SheetFingerprint& a, const SheetFingerprint& b) {
+    if (a.thumb.empty() || b.thumb.empty()) return false;
+    if (a.thumb.size() != b.thumb.size()) return false;
+    if (hamming(a.coarse, b.coarse) > kMaxCoarseHamming) return false;
+
+    cv::Mat diff;
+    cv::absdiff(a.thumb, b.thumb, diff);
+    double maxDiff = 0.0;
+    cv::minMaxLoc(diff, nullptr, &maxDiff);
+    return maxDiff <= kMaxThumbDiff;
+}
+
+std::string makeIdentityKey(const std::map<std::string, std::string>& identity) {
+    auto digits = [](const std::string& s) {
+        std::string d;
+        for (char c : s) if (c >= '0' && c <= '9') d.push_back(c);
+        return d;
+    };
+
+    std::string tc, no;
+    auto it = identity.find("tc_kimlik");
+    if (it != identity.end()) tc = digits(it->second);
+    it = identity.find("ogrenci_no");
+    if (it != identity.end()) no = digits(it->second);
+
+    if (tc.empty() && no.empty()) return "";
+    return "tc:" + tc + "|no:" + no;
+}
+
+SheetIndex::Claim SheetIndex::claim(const std::string& idKey,
+                                    const SheetFingerprint& fp,
+                                    const std::string& path) {
+    Claim c;
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    std::vector<Entry>* bucket = nullptr;
+
+    if (!idKey.empty()) {
+        bucket = &byId_[idKey];
+        for (const auto& e : *bucket) {
+            if (isSameScan(e.fp, fp)) {
+                c.kind = ClaimKind::Rescan;
+                c.originalPath = e.path;
+                c.original = e.outcome;
+                return c;
+            }
+        }
+        if (!bucket->empty()) {
+            c.kind = ClaimKind::DuplicateId;
+            c.originalPath = bucket->front().path;
+        }
+    } else {
+        // Kimlik okunamadı: sadece yakın hash kovalarında aynı taramayı ara. Tüm kovaları
+        // kilit altında gezmek yerine bant indeksinden eşik içindeki kova anahtarları bulunur.
+        static_assert(kHashBands == kBandCount, "SheetIndex::hashBands_ boyutu bant sayisiyla ayni olmali");
+        std::unordered_set<uint64_t> probed;
+        for (int b = 0; b < kBandCount; ++b) {
+            const uint32_t v = bandValue(fp.coarse, b);
+            for (int flip = -1; flip < bandWidth(b); ++flip) {
+                const uint32_t probe = flip < 0 ? v : (v ^ (uint32_t(1) << flip));
+                auto band = hashBands_[b].find(probe);
+                if (band == hashBands_[b].end()) continue;
+                for (uint64_t key : band->second) {
+                    if (hamming(key, fp.coarse) > kMaxCoarseHamming) continue;
+                    if (!probed.insert(key).second) continue;
+                    for (const auto& e : byHash_[key]) {
+                        if (isSameScan(e.fp, fp)) {
+                            c.kind = ClaimKind::Rescan;
+                            c.originalPath = e.path;
+                            c.original = e.outcome;
+                            return c;
+                        }
+                    }
+                }
+            }
+        }
+        bucket = &byHash_[fp.coarse];
+        if (bucket->empty()) {
+            for (int b = 0; b < kBandCount; ++b)
+                hashBands_[b][bandValue(fp.coarse, b)].push_back(fp.coarse);
+        }
+    }
+
+    c.promise = std::make_shared<std::promise<SheetOutcome>>();
+    bucket->push_back({path, fp, c.promise->get_future().share()});
+    return c;
+}
+
+size_t SheetIndex::size() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    size_t n = 0;
+    for (const auto& kv : byId_) n += kv.second.size();
+    for (const auto& kv : byHash_) n += kv.second.size();
+    return n;
+}
+
+}
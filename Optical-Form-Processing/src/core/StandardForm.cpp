@@ -0,0 +1,31 @@
+#include "core/StandardForm.hpp"
+
+namespace core {
+
+#ifdef OMR_FIXED_LAYOUT
+namespace {
+
+constexpr WarpDims kFastDims = layoutWarpDims(kStandardForm, SpeedPreset::Fast);
+constexpr WarpDims kBalancedDims = layoutWarpDims(kStandardForm, SpeedPreset::Balanced);
+constexpr WarpDims kAccurateDims = layoutWarpDims(kStandardForm, SpeedPreset::Accurate);
+
+const FixedLayoutKernel<kStandardForm, kFastDims.width, kFastDims.height> kFastKernel;
+const FixedLayoutKernel<kStandardForm, kBalancedDims.width, kBalancedDims.height> kBalancedKernel;
+const FixedLayoutKernel<kStandardForm, kAccurateDims.width, kAccurateDims.height> kAccurateKernel;
+
+} // namespace
+#endif
+
+const FixedGridScorer* standardFormKernel(cv::Size warpSize) {
+#ifdef OMR_FIXED_LAYOUT
+    for (const FixedGridScorer* k : {static_cast<const FixedGridScorer*>(&kFastKernel),
+                                     static_cast<const FixedGridScorer*>(&kBalancedKernel),
+                                     static_cast<const FixedGridScorer*>(&kAccurateKernel)}) {
+        if (k->warpSize() == warpSize) return k;
+    }
+#endif
+    (void)warpSize;
+    return nullptr;
+}
+
+}
@@ -0,0 +1,122 @@
+#include "core/TemplateConfig.hpp"
+#include "nlohmann/json.hpp"
+
+namespace core {
+
+bool parseTemplateJson(const std::string& json, FormTemplate& out, std::string& err) {
+    out = FormTemplate();
+
+    nlohmann::json j = nlohmann::json::parse(json, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        err = "sablon JSON okunamadi";
+        return false;
+    }
+
+    auto it = j.find("regions");
+    if (it == j.end() || !it->is_array() || it->empty()) {
+        err = "sablonda 'regions' dizisi yok";
+        return false;
+    }
+
+    // Alan tipleri okunmadan önce denetlenir: hatalı şablon istisna değil err ile döner
+    // (C API'de OMR_ERR_TEMPLATE, Python'da ValueError)
+    try {
+        for (const auto& r : *it) {
+            if (!r.is_object()) {
+                err = "bolge nesne olmali";
+                out = FormTemplate();
+                return false;
+            }
+
+            ROIDetector::RegionDef def{};
+            auto name = r.find("name");
+            auto rows = r.find("rows");
+            auto cols = r.find("cols");
+            auto type = r.find("type");
+            auto subject = r.find("subject");
+            auto rect = r.find("rect");
+
+            if (name != r.end() && name->is_string()) def.name = name->get<std::string>();
+            const std::string label = def.name.empty() ? std::string("(isimsiz)") : def.name;
+
+            const bool typesOk =
+                (name != r.end() && name->is_string()) &&
+                (rows != r.end() && rows->is_number_integer()) &&
+                (cols != r.end() && cols->is_number_integer()) &&
+                (type == r.end() || type->is_string()) &&
+                (subject == r.end() || subject->is_boolean()) &&
+                (rect != r.end() && rect->is_array() && rect->size() == 4);
+            if (!typesOk) {
+                err = "gecersiz bolge: " + label;
+                out = FormTemplate();
+                return false;
+            }
+
+            def.rows = rows->get<int>();
+            def.cols = cols->get<int>();
+            def.type = (type != r.end() && type->get<std::string>() == "column") ? ROIDetector::COLUMN
+                                                                                 : ROIDetector::GRID;
+            if (def.name.empty() || def.rows <= 0 || def.cols <= 0) {
+                err = "gecersiz bolge: " + label;
+                out = FormTemplate();
+                return false;
+            }
+
+            for (int k = 0; k < 4; ++k) {
+                const auto& v = (*rect)[k];
+                if (!v.is_number()) {
+                    err = "bolge koordinati sayi olmali: " + def.name;
+                    out = FormTemplate();
+                    return false;
+                }
+                def.rectPct[k] = v.get<float>();
+                if (def.rectPct[k] < 0.f || def.rectPct[k] > 1.f) {
+                    err = "bolge koordinati 0..1 disinda: " + def.name;
+                    out = FormTemplate();
+                    return false;
+                }
+            }
+
+            if (subject != r.end() && subject->get<bool>()) out.subjects.insert(def.name);
+            out.regions.push_back(def);
+        }
+    } catch (const nlohmann::json::exception& e) {
+        err = std::string("sablon JSON hatasi: ") + e.what();
+        out = FormTemplate();
+        return false;
+    }
+    return true;
+}
+
+bool parseAnswerKeyJson(const std::string& json,
+                        std::vector<AnswerKey::QuestionAnswer>& out,
+                        std::string& err) {
+    out.clear();
+
+    nlohmann::json j = nlohmann::json::parse(json, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || j.empty()) {
+        err = "cevap anahtari JSON okunamadi";
+        return false;
+    }
+
+    try {
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            if (!it.value().is_string()) {
+                err = "cevap dizisi metin olmali: " + it.key();
+                out.clear();
+                return false;
+            }
+            const std::string key = it.value().get<std::string>();
+            for (int i = 0; i < static_cast<int>(key.size()); ++i) {
+                out.push_back({it.key(), i, key[i]}); // 0-based
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        err = std::string("cevap anahtari JSON hatasi: ") + e.what();
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+}
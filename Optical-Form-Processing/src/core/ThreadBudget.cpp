@@ -0,0 +1,100 @@
+#include "core/ThreadBudget.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace core {
+
+namespace {
+
+// Decode thread'leri worker'ların yaklaşık dörtte biri kadar çekirdek alır (DCT ölçekli decode ucuz)
+constexpr int kDecodeShareDiv = 4;
+
+// Süreç başındaki kullanılabilir çekirdekler. Sonradan sabitlenen bir thread kendi maskesini
+// daralttığından bir kez, ilk çağrıda okunur.
+const std::vector<int>& processCpus() {
+    static const std::vector<int> cpus = [] {
+        std::vector<int> out;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; ++c)
+                if (CPU_ISSET(c, &set)) out.push_back(c);
+        }
+#endif
+        if (out.empty()) {
+            const int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            for (int c = 0; c < n; ++c) out.push_back(c);
+        }
+        return out;
+    }();
+    return cpus;
+}
+
+} // namespace
+
+int availableCores() {
+    return static_cast<int>(processCpus().size());
+}
+
+ThreadPlan planThreads(const ThreadRequest& req) {
+    ThreadPlan p;
+    p.cores = availableCores();
+
+    if (req.mode == WorkMode::Live) {
+        // Tek kağıt: gecikmeyi OpenCV'nin kağıt içi paralelliği düşürür
+        p.workers = 1;
+        p.decodeThreads = 0;
+        p.opencvThreads = p.cores;
+        p.pin = false;
+        return p;
+    }
+
+    p.decodeThreads = req.decodeThreads > 0 ? req.decodeThreads : std::max(1, p.cores / kDecodeShareDiv);
+    p.workers = req.workers > 0 ? req.workers : std::max(1, p.cores - p.decodeThreads);
+    if (req.jobs > 0) p.workers = std::min<int>(p.workers, static_cast<int>(req.jobs));
+
+    // Worker'lar çekirdekleri dolduruyorsa OpenCV tek thread; az kağıt varsa decode'dan artan
+    // pay kağıt içine (decode çekirdekleri worker'lara dağıtılmaz)
+    p.opencvThreads = std::max(1, (p.cores - p.decodeThreads) / p.workers);
+    p.pin = req.pin && p.opencvThreads == 1;
+    return p;
+}
+
+int applyThreadPlan(const ThreadPlan& plan) {
+    const int prev = cv::getNumThreads();
+    cv::setNumThreads(plan.opencvThreads);
+    return prev;
+}
+
+ScopedThreadPlan::ScopedThreadPlan(const ThreadPlan& plan)
+    : prevOpencvThreads_(applyThreadPlan(plan)) {}
+
+ScopedThreadPlan::~ScopedThreadPlan() {
+    cv::setNumThreads(prevOpencvThreads_);
+}
+
+bool pinCurrentThread(int slot) {
+#ifdef __linux__
+    const std::vector<int>& cpus = processCpus();
+    const int n = static_cast<int>(cpus.size());
+    const int cpu = cpus[((slot % n) + n) % n];
+
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    return pthread_setaffinity_np(pthread_self(), sizeof(one), &one) == 0;
+#else
+    (void)slot;
+    return false;
+#endif
+}
+
+}
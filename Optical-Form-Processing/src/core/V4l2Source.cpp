@@ -0,0 +1,278 @@
+#include "core/V4l2Source.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+// Y düzleminin bir satırındaki bayt sayısı (piksel başına)
+int lumaStep(LumaFormat f) { return f == LumaFormat::Yuyv ? 2 : 1; }
+
+// Tam karenin bayt sayısı (sıkışık satırlar)
+size_t frameBytesFor(LumaFormat f, cv::Size s) {
+    const size_t px = static_cast<size_t>(s.width) * s.height;
+    switch (f) {
+        case LumaFormat::Grey: return px;
+        case LumaFormat::Yuyv: return px * 2;
+        case LumaFormat::Nv12: return px * 3 / 2;
+    }
+    return 0;
+}
+
+#ifdef __linux__
+// Kare bekleme sınırı: bu sürede kare gelmezse kamera kopmuş sayılır
+constexpr int kPollTimeoutMs = 2000;
+
+int xioctl(int fd, unsigned long req, void* arg) {
+    int r;
+    do { r = ioctl(fd, req, arg); } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+uint32_t fourccFor(LumaFormat f) {
+    switch (f) {
+        case LumaFormat::Grey: return V4L2_PIX_FMT_GREY;
+        case LumaFormat::Yuyv: return V4L2_PIX_FMT_YUYV;
+        case LumaFormat::Nv12: return V4L2_PIX_FMT_NV12;
+    }
+    return 0;
+}
+#endif
+
+} // namespace
+
+bool parseLumaFormat(const std::string& s, LumaFormat& out) {
+    if (s == "grey" || s == "gray") { out = LumaFormat::Grey; return true; }
+    if (s == "yuyv") { out = LumaFormat::Yuyv; return true; }
+    if (s == "nv12") { out = LumaFormat::Nv12; return true; }
+    return false;
+}
+
+const char* lumaFormatName(LumaFormat f) {
+    switch (f) {
+        case LumaFormat::Grey: return "grey";
+        case LumaFormat::Yuyv: return "yuyv";
+        case LumaFormat::Nv12: return "nv12";
+    }
+    return "?";
+}
+
+void lumaView(const uchar* data, LumaFormat fmt, cv::Size size, size_t stride, cv::Mat& frame) {
+    uchar* p = const_cast<uchar*>(data);
+    if (fmt == LumaFormat::Yuyv) {
+        cv::Mat packed(size.height, size.width, CV_8UC2, p, stride);
+        cv::extractChannel(packed, frame, 0);
+    } else {
+        frame = cv::Mat(size.height, size.width, CV_8UC1, p, stride);
+    }
+}
+
+/* ---------------- V4l2CameraSource ---------------- */
+
+#ifdef __linux__
+
+V4l2CameraSource::V4l2CameraSource(const V4l2Options& opt) : opt_(opt) {
+    fd_ = ::open(opt.device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0) { fail("acilamadi"); return; }
+
+    v4l2_capability cap{};
+    if (xioctl(fd_, VIDIOC_QUERYCAP, &cap) < 0) { fail("V4L2 aygiti degil"); return; }
+    const uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        fail("yakalama / akis desteklenmiyor");
+        return;
+    }
+
+    // Format: sürücü boyutu yuvarlayabilir, piksel formatı ise birebir tutmalı
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = opt.size.width;
+    fmt.fmt.pix.height = opt.size.height;
+    fmt.fmt.pix.pixelformat = fourccFor(opt.format);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(fd_, VIDIOC_S_FMT, &fmt) < 0) { fail("format ayarlanamadi"); return; }
+    if (fmt.fmt.pix.pixelformat != fourccFor(opt.format)) {
+        errno = 0;
+        fail(std::string("format desteklenmiyor: ") + lumaFormatName(opt.format));
+        return;
+    }
+    size_ = cv::Size(static_cast<int>(fmt.fmt.pix.width), static_cast<int>(fmt.fmt.pix.height));
+    stride_ = fmt.fmt.pix.bytesperline ? fmt.fmt.pix.bytesperline
+                                       : static_cast<size_t>(size_.width) * lumaStep(opt.format);
+
+    // Kare hızı isteğe bağlı; desteklemeyen sürücüde varsayılan kalır
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (opt.fps > 0.0) {
+        parm.parm.capture.timeperframe.numerator = 1000;
+        parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(opt.fps * 1000.0);
+        xioctl(fd_, VIDIOC_S_PARM, &parm);
+    }
+
+    v4l2_requestbuffers req{};
+    req.count = static_cast<uint32_t>(std::max(2, opt.bufferCount));
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) { fail("tampon alinamadi"); return; }
+
+    buffers_.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer b{};
+        b.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        b.memory = V4L2_MEMORY_MMAP;
+        b.index = i;
+        if (xioctl(fd_, VIDIOC_QUERYBUF, &b) < 0) { fail("tampon sorgulanamadi"); return; }
+
+        void* p = mmap(nullptr, b.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, b.m.offset);
+        if (p == MAP_FAILED) { fail("mmap basarisiz"); return; }
+        buffers_[i].start = p;
+        buffers_[i].length = b.length;
+
+        if (xioctl(fd_, VIDIOC_QBUF, &b) < 0) { fail("tampon kuyruga alinamadi"); return; }
+    }
+
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) { fail("akis baslatilamadi"); return; }
+    streaming_ = true;
+}
+
+V4l2CameraSource::~V4l2CameraSource() { shutdown(); }
+
+bool V4l2CameraSource::fail(const std::string& what) {
+    err_ = opt_.device + ": " + what;
+    if (errno) err_ += std::string(" (") + std::strerror(errno) + ")";
+    shutdown();
+    return false;
+}
+
+void V4l2CameraSource::shutdown() {
+    if (fd_ >= 0 && streaming_) {
+        int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd_, VIDIOC_STREAMOFF, &type);
+    }
+    streaming_ = false;
+    for (auto& b : buffers_) {
+        if (b.start) munmap(b.start, b.length);
+    }
+    buffers_.clear();
+    held_ = -1;
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+bool V4l2CameraSource::read(cv::Mat& frame) {
+    if (!streaming_) return false;
+
+    // Önceki kare artık kullanılmıyor: tamponu sürücüye geri ver
+    if (held_ >= 0) {
+        v4l2_buffer b{};
+        b.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        b.memory = V4L2_MEMORY_MMAP;
+        b.index = static_cast<uint32_t>(held_);
+        held_ = -1;
+        if (xioctl(fd_, VIDIOC_QBUF, &b) < 0) return false;
+    }
+
+    for (;;) {
+        pollfd pfd{fd_, POLLIN, 0};
+        int r = poll(&pfd, 1, kPollTimeoutMs);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+
+        v4l2_buffer b{};
+        b.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        b.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(fd_, VIDIOC_DQBUF, &b) < 0) {
+            if (errno == EAGAIN) continue;
+            return false;
+        }
+
+        // Bozuk / eksik kare: tamponu geri ver ve sıradakini bekle
+        if ((b.flags & V4L2_BUF_FLAG_ERROR) ||
+            (b.bytesused != 0 && b.bytesused < stride_ * static_cast<size_t>(size_.height))) {
+            if (xioctl(fd_, VIDIOC_QBUF, &b) < 0) return false;
+            continue;
+        }
+
+        held_ = static_cast<int>(b.index);
+
+        const double ts = b.timestamp.tv_sec * 1000.0 + b.timestamp.tv_usec / 1000.0;
+        if (ts0Ms_ < 0.0) ts0Ms_ = ts;
+        tsMs_ = ts - ts0Ms_;
+
+        const long seq = static_cast<long>(b.sequence);
+        if (lastSeq_ >= 0 && seq > lastSeq_ + 1) dropped_ += seq - lastSeq_ - 1;
+        lastSeq_ = seq;
+
+        lumaView(static_cast<const uchar*>(buffers_[held_].start), opt_.format, size_, stride_, frame);
+        return true;
+    }
+}
+
+#else
+
+V4l2CameraSource::V4l2CameraSource(const V4l2Options& opt) : opt_(opt) {
+    err_ = "V4L2 sadece Linux'ta destekleniyor";
+}
+
+V4l2CameraSource::~V4l2CameraSource() = default;
+
+bool V4l2CameraSource::fail(const std::string& what) {
+    err_ = what;
+    return false;
+}
+
+void V4l2CameraSource::shutdown() {}
+
+bool V4l2CameraSource::read(cv::Mat&) { return false; }
+
+#endif
+
+std::string V4l2CameraSource::describe() const {
+    return "v4l2 " + opt_.device + " " + lumaFormatName(opt_.format) + " " +
+           std::to_string(size_.width) + "x" + std::to_string(size_.height) +
+           " (" + std::to_string(buffers_.size()) + " tampon)";
+}
+
+/* ---------------- RawLumaFileSource ---------------- */
+
+RawLumaFileSource::RawLumaFileSource(const std::string& path, LumaFormat fmt, cv::Size size,
+                                     double fps, Pacing pacing)
+    : in_(path, std::ios::binary), path_(path), fmt_(fmt), size_(size),
+      pacer_(pacing), fps_(fps > 0.0 ? fps : 30.0) {
+    if (size.width <= 0 || size.height <= 0) return;
+    stride_ = static_cast<size_t>(size.width) * lumaStep(fmt);
+    frameBytes_ = frameBytesFor(fmt, size);
+    raw_.create(1, static_cast<int>(frameBytes_), CV_8UC1);
+}
+
+bool RawLumaFileSource::read(cv::Mat& frame) {
+    if (!isOpened()) return false;
+    if (!in_.read(reinterpret_cast<char*>(raw_.data), static_cast<std::streamsize>(frameBytes_))) return false;
+
+    lumaView(raw_.data, fmt_, size_, stride_, frame);
+
+    tsMs_ = index_ * 1000.0 / fps_;
+    ++index_;
+    pacer_.wait(tsMs_);
+    return true;
+}
+
+std::string RawLumaFileSource::describe() const {
+    return std::string("ham kayit ") + path_ + " " + lumaFormatName(fmt_) + " " +
+           std::to_string(size_.width) + "x" + std::to_string(size_.height);
+}
+
+}
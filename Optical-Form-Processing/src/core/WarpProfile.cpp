@@ -0,0 +1,51 @@
+#include "core/WarpProfile.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+int scaledKernel(int base, double scale, bool odd) {
+    int k = static_cast<int>(std::lround(base * scale));
+    if (!odd) return std::max(1, k);
+    k |= 1;
+    return std::max(3, k);
+}
+
+WarpProfile makeWarpProfile(const cv::Size2f& minPitch, double targetBubblePx) {
+    WarpProfile p;
+    if (minPitch.width <= 0.f || minPitch.height <= 0.f || targetBubblePx <= 0.0) return p;
+
+    const WarpDims d = warpDimsFor(minPitch.width, minPitch.height, targetBubblePx);
+    p.width = d.width;
+    p.height = d.height;
+    p.scale = static_cast<double>(p.width) / kReferenceWarpW;
+    p.bubblePx = kBubbleToPitch * std::min(minPitch.width * p.width, minPitch.height * p.height);
+    return p;
+}
+
+WarpProfile makeWarpProfile(const cv::Size2f& minPitch, SpeedPreset preset) {
+    if (preset != SpeedPreset::Accurate) return makeWarpProfile(minPitch, targetBubblePx(preset));
+
+    WarpProfile p;   // Referans boyut, ölçek 1.0
+    if (minPitch.width > 0.f && minPitch.height > 0.f)
+        p.bubblePx = kBubbleToPitch * std::min(minPitch.width * p.width, minPitch.height * p.height);
+    return p;
+}
+
+bool parseSpeedPreset(const std::string& s, SpeedPreset& out) {
+    if (s == "fast")     { out = SpeedPreset::Fast; return true; }
+    if (s == "balanced") { out = SpeedPreset::Balanced; return true; }
+    if (s == "accurate") { out = SpeedPreset::Accurate; return true; }
+    return false;
+}
+
+const char* presetName(SpeedPreset preset) {
+    switch (preset) {
+        case SpeedPreset::Fast:     return "fast";
+        case SpeedPreset::Balanced: return "balanced";
+        case SpeedPreset::Accurate: return "accurate";
+    }
+    return "?";
+}
+
+}
@@ -2,11 +2,25 @@
 #include "PerspectiveCorrector.hpp"
 #include "ROIDetector.hpp"
 #include "AnswerKey.hpp"
+#include "BatchRunner.hpp"
+#include "FrameSource.hpp"
+#include "FrameQualityGate.hpp"
+#include "AutoCapture.hpp"
+#include "WarpProfile.hpp"
+#include "DecodeTrace.hpp"
+#include "OverlayLayer.hpp"
+#include "FramePool.hpp"
+#include "V4l2Source.hpp"
+#include "SearchWindow.hpp"
+#include "ThreadBudget.hpp"
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <map>
 #include <vector>
 
@@ -16,45 +30,35 @@ using namespace std;
 /* =========================================================
    SCORE OVERLAY
    ========================================================= */
-static void drawScoreOverlay(cv::Mat& frame, const AnswerKey::ScoreResult& score) {
+static void drawScoreOverlay(core::OverlayLayer& layer, const AnswerKey::ScoreResult& score) {
     int boxWidth = 550;
-    int startX = frame.cols - boxWidth - 20;
+    int startX = layer.size().width - boxWidth - 20;
     int startY = 40;
     int lineHeight = 45;
 
     int boxHeight = 220 + (static_cast<int>(score.subjectDetails.size()) * lineHeight);
-    cv::Rect bgRect(startX - 10, 10, boxWidth, boxHeight);
-    bgRect = bgRect & cv::Rect(0, 0, frame.cols, frame.rows);
+    layer.fillRect(cv::Rect(startX - 10, 10, boxWidth, boxHeight), cv::Scalar(0, 0, 0), 0.8);
 
-    if (bgRect.area() > 0) {
-        cv::Mat roi = frame(bgRect);
-        cv::Mat color(roi.size(), CV_8UC3, cv::Scalar(0, 0, 0));
-        cv::addWeighted(color, 0.8, roi, 0.2, 0, roi);
-    }
-
-    cv::putText(frame, "PUANLAMA DETAYI", cv::Point(startX, startY),
-                cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 255), 3);
+    layer.putText("PUANLAMA DETAYI", cv::Point(startX, startY), 1.0, cv::Scalar(0, 255, 255), 3);
 
     startY += 50;
 
     stringstream ss;
     ss << "PUAN: " << fixed << setprecision(2) << score.totalScore;
-    cv::putText(frame, ss.str(), cv::Point(startX, startY),
-                cv::FONT_HERSHEY_SIMPLEX, 1.5, cv::Scalar(0, 255, 0), 4);
+    layer.putText(ss.str(), cv::Point(startX, startY), 1.5, cv::Scalar(0, 255, 0), 4);
 
     startY += 45;
 
     ss.str("");
     ss << "TOPLAM: " << score.totalCorrect << " D | "
        << score.totalWrong << " Y | " << score.totalEmpty << " B";
-    cv::putText(frame, ss.str(), cv::Point(startX, startY),
-                cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(255, 255, 255), 2);
+    layer.putText(ss.str(), cv::Point(startX, startY), 0.8, cv::Scalar(255, 255, 255), 2);
 
     startY += 40;
 
-    cv::line(frame, cv::Point(startX, startY - 10),
-             cv::Point(startX + boxWidth - 20, startY - 10),
-             cv::Scalar(200, 200, 200), 2);
+    layer.line(cv::Point(startX, startY - 10),
+               cv::Point(startX + boxWidth - 20, startY - 10),
+               cv::Scalar(200, 200, 200), 2);
 
     for (const auto& pair : score.subjectDetails) {
         std::string name = pair.first;
@@ -75,8 +79,7 @@ static void drawScoreOverlay(cv::Mat& frame, const AnswerKey::ScoreResult& score
            << stat.empty << "B "
            << " Net: " << fixed << setprecision(1) << stat.net;
 
-        cv::putText(frame, ss.str(), cv::Point(startX, startY),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.85, cv::Scalar(255, 255, 255), 2);
+        layer.putText(ss.str(), cv::Point(startX, startY), 0.85, cv::Scalar(255, 255, 255), 2);
 
         startY += lineHeight;
     }
@@ -117,13 +120,8 @@ static std::string shortName(const std::string& subject) {
     return subject;
 }
 
-static char getStudentAnswerAt(const std::map<std::string, std::string>& studentAnswersCsv,
-                               const std::string& subject,
-                               int qIndex0) {
-    auto it = studentAnswersCsv.find(subject);
-    if (it == studentAnswersCsv.end()) return '-';
-
-    auto tokens = splitCSV(it->second);
+// tokens: dersin cevap dizisi (splitCSV ile ders başına bir kez ayrılır)
+static char getStudentAnswerAt(const std::vector<std::string>& tokens, int qIndex0) {
     if (qIndex0 < 0 || qIndex0 >= (int)tokens.size()) return '-';
 
     std::string a = tokens[qIndex0];
@@ -146,7 +144,7 @@ static std::string safeGet(const std::map<std::string, std::string>& m, const st
     return it->second;
 }
 
-static void drawIdentityOverlay(cv::Mat& frame,
+static void drawIdentityOverlay(core::OverlayLayer& layer,
                                 const std::map<std::string, std::string>& studentAnswers,
                                 cv::Point origin = {40, 80}) {
     int x = origin.x;
@@ -157,42 +155,42 @@ static void drawIdentityOverlay(cv::Mat& frame,
     std::string name = safeGet(studentAnswers, "adi_soyadi");
 
     // Büyük siyah başlık + bilgiler
-    cv::putText(frame, "KIMLIK BILGILERI",
-                {x, y},
-                cv::FONT_HERSHEY_SIMPLEX,
-                1.05, cv::Scalar(0, 0, 255), 4);
+    layer.putText("KIMLIK BILGILERI", {x, y}, 1.05, cv::Scalar(0, 0, 255), 4);
 
     y += 42;
 
     if (!tc.empty()) {
-        cv::putText(frame, "TC: " + tc,
-                    {x, y},
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    1.0, cv::Scalar(0, 0, 255), 4);
+        layer.putText("TC: " + tc, {x, y}, 1.0, cv::Scalar(0, 0, 255), 4);
         y += 38;
     }
 
     if (!no.empty()) {
-        cv::putText(frame, "NO: " + no,
-                    {x, y},
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    1.0, cv::Scalar(0, 0, 255), 4);
+        layer.putText("NO: " + no, {x, y}, 1.0, cv::Scalar(0, 0, 255), 4);
         y += 38;
     }
 
     if (!name.empty()) {
-        cv::putText(frame, "AD: " + name,
-                    {x, y},
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    1.0, cv::Scalar(0, 0, 255), 4);
+        layer.putText("AD: " + name, {x, y}, 1.0, cv::Scalar(0, 0, 255), 4);
         y += 38;
     }
 }
 
+// Pencere açık ve görünürse görüntü alanının boyutu (debug görselleri bu boyutta üretilir)
+static bool visibleWindowSize(const std::string& name, cv::Size& size) {
+    try {
+        if (cv::getWindowProperty(name, cv::WND_PROP_VISIBLE) <= 0) return false;
+        cv::Rect r = cv::getWindowImageRect(name);
+        size = (r.width > 0 && r.height > 0) ? r.size() : cv::Size(480, 640);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 /* =========================================================
    COMPARISON OVERLAY (Student vs AnswerKey)
    ========================================================= */
-static void drawComparisonOverlay(cv::Mat& frame,
+static void drawComparisonOverlay(core::OverlayLayer& layer,
                                   const std::map<std::string, std::string>& studentAnswersCsv,
                                   const std::map<std::string, std::map<int, char>>& answerKeyMap,
                                   cv::Point origin = {40, 180},
@@ -200,10 +198,7 @@ static void drawComparisonOverlay(cv::Mat& frame,
     int x = origin.x;
     int y = origin.y;
 
-    cv::putText(frame, "CEVAP KARSILASTIRMA (Ogrenci / Dogru)",
-                {x, y},
-                cv::FONT_HERSHEY_SIMPLEX,
-                1.0, cv::Scalar(0, 0, 0), 4);
+    layer.putText("CEVAP KARSILASTIRMA (Ogrenci / Dogru)", {x, y}, 1.0, cv::Scalar(0, 0, 0), 4);
 
     y += 40;
 
@@ -217,12 +212,13 @@ static void drawComparisonOverlay(cv::Mat& frame,
         auto itKey = answerKeyMap.find(subj);
         if (itKey == answerKeyMap.end()) continue;
 
-        cv::putText(frame, shortName(subj) + ":",
-                    {x, y},
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    0.95, cv::Scalar(0, 0, 0), 3);
+        layer.putText(shortName(subj) + ":", {x, y}, 0.95, cv::Scalar(0, 0, 0), 3);
         y += 30;
 
+        std::vector<std::string> tokens;
+        auto itAns = studentAnswersCsv.find(subj);
+        if (itAns != studentAnswersCsv.end()) tokens = splitCSV(itAns->second);
+
         int maxQ = -1;
         for (const auto& qp : itKey->second) maxQ = std::max(maxQ, qp.first);
         int totalQ = maxQ + 1;
@@ -235,7 +231,7 @@ static void drawComparisonOverlay(cv::Mat& frame,
             auto itC = itKey->second.find(qi);
             if (itC != itKey->second.end()) correct = itC->second;
 
-            char student = getStudentAnswerAt(studentAnswersCsv, subj, qi);
+            char student = getStudentAnswerAt(tokens, qi);
 
             std::string status;
             cv::Scalar color;
@@ -248,10 +244,7 @@ static void drawComparisonOverlay(cv::Mat& frame,
             std::stringstream ss;
             ss << "Q" << (qi + 1) << ": " << student << " / " << correct << "  " << status;
 
-            cv::putText(frame, ss.str(),
-                        {x + 20, y},
-                        cv::FONT_HERSHEY_SIMPLEX,
-                        0.80, color, 2);
+            layer.putText(ss.str(), {x + 20, y}, 0.80, color, 2);
 
             y += 24;
             lines++;
@@ -261,41 +254,341 @@ static void drawComparisonOverlay(cv::Mat& frame,
     }
 }
 
+// Sonuç ekranı (skor + kimlik + karşılaştırma + başlık) katmanı.
+// İçerik değiştiğinde bir kez çizilir; karelerde sadece OverlayLayer::composite çağrılır.
+static void buildResultLayer(core::OverlayLayer& layer, cv::Size frameSize,
+                             const AnswerKey::ScoreResult& score,
+                             const std::map<std::string, std::string>& answers,
+                             const std::map<std::string, std::map<int, char>>& answerKeyMap,
+                             bool showCompare,
+                             const std::string& title, const cv::Scalar& titleColor,
+                             int borderThickness) {
+    layer.begin(frameSize);
+
+    // 1) Score overlay
+    if (score.totalQuestions > 0) drawScoreOverlay(layer, score);
+
+    // 2) Kimlik bilgileri
+    drawIdentityOverlay(layer, answers, {40, 70});
+
+    // 3) Student vs Correct overlay (aşağıdan başlasın)
+    if (showCompare) drawComparisonOverlay(layer, answers, answerKeyMap, {40, 220}, 70);
+
+    if (borderThickness > 0) {
+        layer.rectangle(cv::Rect(0, 0, frameSize.width, frameSize.height), titleColor, borderThickness);
+    }
+    layer.putText(title, cv::Point(40, 40), 0.8, titleColor, 2);
+
+    layer.end();
+}
+
+static std::vector<AnswerKey::QuestionAnswer> buildAnswerKeyList() {
+    std::vector<AnswerKey::QuestionAnswer> answers;
+
+    addSubjectKey(answers, "turkce",    "CBAABDBCCCCDABABCAAD");
+    addSubjectKey(answers, "sosyal",    "BBDABBACADCBAACDDCCD");
+    addSubjectKey(answers, "din",       "BABDBABDBACDBBAACBDB");
+    addSubjectKey(answers, "ingilizce", "BABDBABDBACDBBAACBDB");
+    addSubjectKey(answers, "matematik", "BABDBABDBACDBBAACBDB");
+    addSubjectKey(answers, "fen",       "BABDBABDBACDBBAACBDB");
+
+    return answers;
+}
+
+/* =========================================================
+   BATCH MODE
+   ./omr --batch <dosya|klasor>... [--out sonuc.jsonl] [--workers N] [--no-dedup]
+                 [--readers N] [--decoders N] [--prefetch N] [--no-uring]
+                 [--preset fast|balanced|accurate] [--scoring threshold|darkness]
+                 [--scanner] [--dropout red|green|blue] [--pin]
+   ========================================================= */
+static int runBatch(int argc, char** argv) {
+    core::BatchOptions opt;
+    std::string outPath;
+    std::vector<std::string> inputs;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (a == "--workers" && i + 1 < argc) opt.workers = std::atoi(argv[++i]);
+        else if (a == "--no-dedup") opt.detectDuplicates = false;
+        else if (a == "--readers" && i + 1 < argc) opt.readThreads = std::atoi(argv[++i]);
+        else if (a == "--decoders" && i + 1 < argc) opt.decodeThreads = std::atoi(argv[++i]);
+        else if (a == "--prefetch" && i + 1 < argc) opt.prefetchDepth = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (a == "--no-uring") opt.useIoUring = false;
+        else if (a == "--preset" && i + 1 < argc) {
+            std::string p = argv[++i];
+            if (!core::parseSpeedPreset(p, opt.preset)) {
+                std::cerr << "Bilinmeyen preset: " << p << " (fast|balanced|accurate)\n";
+                return 1;
+            }
+        }
+        else if (a == "--scoring" && i + 1 < argc) opt.darknessScoring = (std::string(argv[++i]) == "darkness");
+        else if (a == "--scanner") opt.scannerMode = true;
+        else if (a == "--pin") opt.pinThreads = true;
+        else if (a == "--dropout" && i + 1 < argc) {
+            std::string c = argv[++i];
+            if (!core::parseDropoutChannel(c, opt.dropout)) {
+                std::cerr << "Bilinmeyen dropout kanali: " << c << " (red|green|blue|none)\n";
+                return 1;
+            }
+        }
+        else inputs.push_back(a);
+    }
+
+    auto paths = core::collectImagePaths(inputs);
+    if (paths.empty()) {
+        std::cerr << "Islenecek goruntu yok.\n";
+        std::cerr << "Kullanim: ./omr --batch <dosya|klasor>... [--out sonuc.jsonl] [--workers N] [--no-dedup]\n"
+                  << "          [--readers N] [--decoders N] [--prefetch N] [--no-uring]\n"
+                  << "          [--preset fast|balanced|accurate] [--scoring threshold|darkness]\n"
+                  << "          [--scanner] [--dropout red|green|blue] [--pin]\n";
+        return 1;
+    }
+
+    AnswerKey answerKey;
+    answerKey.loadAnswerKey(buildAnswerKeyList());
+
+    core::BatchRunner runner(answerKey, opt);
+    const auto& wp = runner.warpProfile();
+    std::cerr << "Warp: " << wp.width << "x" << wp.height << " (" << core::presetName(opt.preset)
+              << ", bubble ~" << std::fixed << std::setprecision(1) << wp.bubblePx << " px)\n";
+    if (opt.dropout != core::DropoutChannel::None)
+        std::cerr << "Dropout kanali: " << core::dropoutChannelName(opt.dropout) << " (grid temizligi yok)\n";
+    auto items = runner.run(paths);
+
+    std::ofstream outFile;
+    if (!outPath.empty()) {
+        outFile.open(outPath);
+        if (!outFile) {
+            std::cerr << "Cikti dosyasi acilamadi: " << outPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = outPath.empty() ? std::cout : outFile;
+
+    std::map<core::BatchItem::Status, int> counts;
+    double totalMs = 0.0;
+    for (const auto& item : items) {
+        out << core::toJsonLine(item) << "\n";
+        counts[item.status]++;
+        totalMs += item.elapsedMs;
+    }
+
+    std::cerr << "Toplam " << items.size() << " kagit | "
+              << "ok: " << counts[core::BatchItem::Status::Ok] << " | "
+              << "tekrar tarama (atlandi): " << counts[core::BatchItem::Status::Rescan] << " | "
+              << "ayni kimlik (inceleme): " << counts[core::BatchItem::Status::DuplicateId] << " | "
+              << "kagit yok: " << counts[core::BatchItem::Status::NoPaper] << " | "
+              << "okuma hatasi: " << counts[core::BatchItem::Status::ReadError] << "\n";
+    std::cerr << "Ortalama sure: " << std::fixed << std::setprecision(1)
+              << (items.empty() ? 0.0 : totalMs / items.size()) << " ms/kagit\n";
+
+    // G/Ç ve hesaplama ayrı: worker'lar çok bekliyorsa darboğaz disk/ağdır
+    const auto& st = runner.lastStats();
+    std::cerr << "Sure (ms) | duvar: " << st.wallMs
+              << " | G/C bekleme: " << st.ioWaitMs
+              << " | decode: " << st.decodeMs
+              << " | hesaplama: " << st.computeMs
+              << " | worker bosta: " << st.workerStarvedMs
+              << " | okunan: " << (st.bytesRead / (1024.0 * 1024.0)) << " MB"
+              << (st.usedIoUring ? " (io_uring)" : " (thread okuyucu)") << "\n";
+    std::cerr << "Thread | cekirdek: " << st.threads.cores
+              << " | worker: " << st.threads.workers
+              << " | decode: " << st.threads.decodeThreads
+              << " | OpenCV: " << st.threads.opencvThreads
+              << (st.threads.pin ? " | sabitlenmis" : "") << "\n";
+    if (opt.scannerMode) {
+        std::cerr << "Tarayici hizli yolu: " << st.scanAligned << " kagit"
+                  << " (digerleri tam perspektif yoluna dustu)\n";
+    }
+    return 0;
+}
+
+/* =========================================================
+   LOOP STATS (fps / kare başı gecikme)
+   ========================================================= */
+struct LoopStats {
+    std::vector<double> latencyMs;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    void add(double ms) { latencyMs.push_back(ms); }
+
+    void print(std::ostream& os) const {
+        if (latencyMs.empty()) return;
+
+        double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::vector<double> v = latencyMs;
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        auto pct = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))]; };
+
+        os << std::fixed << std::setprecision(1)
+           << "Kare: " << v.size()
+           << " | fps: " << (wallS > 0 ? v.size() / wallS : 0.0)
+           << " | gecikme ms: ort " << sum / v.size()
+           << ", p50 " << pct(0.50)
+           << ", p95 " << pct(0.95)
+           << ", maks " << v.back() << "\n";
+    }
+};
+
 /* =========================================================
    MAIN
+   ./omr [kamera_index]
+   ./omr --video kayit.mp4 [--pace realtime|fast]
+   ./omr --images klasor_veya_desen [--fps 30] [--pace realtime|fast]
+   ./omr --v4l2 /dev/video0 [--pix yuyv|grey|nv12] [--size 1920x1080] [--buffers 4]
+   ./omr --raw kayit.yuyv --size 1920x1080 [--pix yuyv|grey|nv12] [--fps 30] [--pace realtime|fast]
+   Ek: --headless (pencere yok, sadece istatistik), --max-frames N
+       --preset fast|balanced|accurate (warp çözünürlüğü, varsayılan balanced)
+       --scoring threshold|darkness (bubble puanlama yöntemi)
+       --cascade (önce yarım çözünürlük, sadece belirsiz satırlar tam; omr_bench ile doğrulayın)
+       --no-window (kağıt kilitlense de her karede tüm kareyi tara)
+       --camera-profile kamera.yml (lens bozulması perspektif düzeltmesine katlanır)
+       --dropout red|green|blue (dropout mürekkepli form: bu kanal okunur, grid temizliği yok)
+       --auto (kağıt sabitlenince otomatik notlandır, JSON satırı stdout'a)
    ========================================================= */
 int main(int argc, char** argv) {
-    int camIndex = 0;
-    if (argc > 1) camIndex = std::atoi(argv[1]);
+    if (argc > 1 && std::string(argv[1]) == "--batch") return runBatch(argc, argv);
+
+    core::FrameSourceSpec srcSpec;
+    bool headless = false;
+    bool autoMode = false;
+    bool darknessScoring = false;
+    bool cascade = false;
+    bool searchWindowOn = true;
+    core::SpeedPreset preset = core::SpeedPreset::Balanced;
+    long maxFrames = -1;
+    std::string cameraProfilePath;
+    core::DropoutChannel dropout = core::DropoutChannel::None;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--video" && i + 1 < argc) {
+            srcSpec.kind = core::FrameSourceSpec::Kind::Video;
+            srcSpec.path = argv[++i];
+        } else if (a == "--images" && i + 1 < argc) {
+            srcSpec.kind = core::FrameSourceSpec::Kind::Images;
+            srcSpec.path = argv[++i];
+        } else if (a == "--v4l2" && i + 1 < argc) {
+            srcSpec.kind = core::FrameSourceSpec::Kind::V4l2;
+            srcSpec.path = argv[++i];
+        } else if (a == "--raw" && i + 1 < argc) {
+            srcSpec.kind = core::FrameSourceSpec::Kind::RawLuma;
+            srcSpec.path = argv[++i];
+        } else if (a == "--pix" && i + 1 < argc) {
+            std::string p = argv[++i];
+            if (!core::parseLumaFormat(p, srcSpec.lumaFormat)) {
+                std::cerr << "Bilinmeyen piksel formati: " << p << " (yuyv|grey|nv12)\n";
+                return 1;
+            }
+        } else if (a == "--size" && i + 1 < argc) {
+            int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) {
+                std::cerr << "Gecersiz boyut: " << argv[i] << " (ornek 1920x1080)\n";
+                return 1;
+            }
+            srcSpec.frameSize = cv::Size(w, h);
+        } else if (a == "--buffers" && i + 1 < argc) {
+            srcSpec.bufferCount = std::atoi(argv[++i]);
+        } else if (a == "--pace" && i + 1 < argc) {
+            std::string p = argv[++i];
+            srcSpec.pacing = (p == "fast") ? core::Pacing::AsFastAsPossible : core::Pacing::RealTime;
+        } else if (a == "--fps" && i + 1 < argc) {
+            srcSpec.sequenceFps = std::atof(argv[++i]);
+        } else if (a == "--headless") {
+            headless = true;
+        } else if (a == "--preset" && i + 1 < argc) {
+            std::string p = argv[++i];
+            if (!core::parseSpeedPreset(p, preset)) {
+                std::cerr << "Bilinmeyen preset: " << p << " (fast|balanced|accurate)\n";
+                return 1;
+            }
+        } else if (a == "--scoring" && i + 1 < argc) {
+            darknessScoring = (std::string(argv[++i]) == "darkness");
+        } else if (a == "--cascade") {
+            cascade = true;
+        } else if (a == "--no-cascade") {
+            cascade = false;
+        } else if (a == "--no-window") {
+            searchWindowOn = false;
+        } else if (a == "--camera-profile" && i + 1 < argc) {
+            cameraProfilePath = argv[++i];
+        } else if (a == "--dropout" && i + 1 < argc) {
+            std::string c = argv[++i];
+            if (!core::parseDropoutChannel(c, dropout)) {
+                std::cerr << "Bilinmeyen dropout kanali: " << c << " (red|green|blue|none)\n";
+                return 1;
+            }
+        } else if (a == "--auto") {
+            autoMode = true;
+        } else if (a == "--max-frames" && i + 1 < argc) {
+            maxFrames = std::atol(argv[++i]);
+        } else {
+            srcSpec.cameraIndex = std::atoi(argv[i]);
+        }
+    }
 
-    cv::VideoCapture cap(camIndex, cv::CAP_ANY);
-    if (!cap.isOpened()) {
-        std::cerr << "Kamera acilamadi! Index: " << camIndex << "\n";
-        std::cerr << "Deneme: ./omr 0   veya   ./omr 1\n";
+    std::string srcErr;
+    auto source = core::openFrameSource(srcSpec, srcErr);
+    if (!source) {
+        std::cerr << srcErr << "\n";
+        std::cerr << "Deneme: ./omr 0   veya   ./omr 1   veya   ./omr --video kayit.mp4\n";
         return 1;
     }
+    std::cerr << "Kaynak: " << source->describe() << "\n";
 
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, 1920);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, 1080);
-    cap.set(cv::CAP_PROP_FPS, 30);
-    cap.set(cv::CAP_PROP_AUTOFOCUS, 1);
+    // Canlı mod tek kağıt akışıdır: çekirdekler OpenCV'nin kağıt içi paralelliğine verilir
+    core::ThreadRequest threadReq;
+    threadReq.mode = core::WorkMode::Live;
+    const core::ThreadPlan threadPlan = core::planThreads(threadReq);
+    core::applyThreadPlan(threadPlan);
+    std::cerr << "OpenCV thread: " << threadPlan.opencvThreads << " / " << threadPlan.cores << " cekirdek\n";
 
-    core::PerspectiveCorrector pc(1600, 2200);
+    LoopStats loopStats;
 
     ROIDetector detector;
+
+    // Warp boyutu şablondaki en küçük bubble aralığından türetilir (--preset)
+    core::WarpProfile warpProfile = core::makeWarpProfile(detector.minCellPitch(), preset);
+    core::PerspectiveCorrector pc(warpProfile.width, warpProfile.height);
+    pc.setKernelScale(warpProfile.scale);
+    if (!cameraProfilePath.empty()) {
+        core::CameraProfile cam;
+        std::string camErr;
+        if (!core::loadCameraProfile(cameraProfilePath, cam, camErr)) {
+            std::cerr << camErr << "\n";
+            return 1;
+        }
+        pc.setCameraProfile(cam);
+        std::cerr << "Kamera profili: " << cameraProfilePath << " (f " << std::fixed << std::setprecision(1)
+                  << cam.fx << "/" << cam.fy << ", k1 " << std::setprecision(4) << cam.k[0] << ")\n"
+                  << std::defaultfloat;
+    }
+    detector.setWarpScale(warpProfile.scale);
+    if (darknessScoring) detector.setScoringMode(ROIDetector::SCORE_DARKNESS);
+    detector.setCascade(cascade);
+    if (dropout != core::DropoutChannel::None) {
+        pc.setDropoutChannel(dropout);
+        detector.setDropoutMode(true);
+        std::cerr << "Dropout kanali: " << core::dropoutChannelName(dropout) << " (grid temizligi yok)\n";
+        // V4L2 / ham kayıt sadece parlaklık düzlemini verir; kanal seçilecek renk yoktur
+        if (srcSpec.kind == core::FrameSourceSpec::Kind::V4l2 || srcSpec.kind == core::FrameSourceSpec::Kind::RawLuma)
+            std::cerr << "Uyari: bu kaynak renk vermiyor, dropout kanali yerine parlaklik okunur\n";
+    }
+    std::cerr << "Warp: " << warpProfile.width << "x" << warpProfile.height
+              << " (" << core::presetName(preset) << ", bubble ~"
+              << static_cast<int>(warpProfile.bubblePx + 0.5) << " px)\n";
+
+    pc.setLayoutSignature(detector.layoutSignature()); // Yön otomatik bulunur (R: elle)
     detector.setFillThreshold(0.40);
+    detector.setTemporalFusion(true, 5); // Kararı oturan bölgeler tekrar okunmaz
 
     // --- ANSWER KEY ---
     AnswerKey answerKey;
-    std::vector<AnswerKey::QuestionAnswer> answers;
-
-    addSubjectKey(answers, "turkce",    "CBAABDBCCCCDABABCAAD");
-    addSubjectKey(answers, "sosyal",    "BBDABBACADCBAACDDCCD");
-    addSubjectKey(answers, "din",       "BABDBABDBACDBBAACBDB");
-    addSubjectKey(answers, "ingilizce", "BABDBABDBACDBBAACBDB");
-    addSubjectKey(answers, "matematik", "BABDBABDBACDBBAACBDB");
-    addSubjectKey(answers, "fen",       "BABDBABDBACDBBAACBDB");
-
+    std::vector<AnswerKey::QuestionAnswer> answers = buildAnswerKeyList();
     answerKey.loadAnswerKey(answers);
 
     // AnswerKeyMap (student vs correct karşılaştırma için)
@@ -307,135 +600,315 @@ int main(int argc, char** argv) {
     bool showDebug = true;
     bool showBubbleDebug = true;
     bool showCompareOverlay = true;
-    int rotationMode = 0;
+    bool useQualityGate = true;
+    int rotationMode = -1;   // -1: otomatik yön, 0..3: elle 90° adım
+
+    core::FrameQualityGate qualityGate;
+
+    // Kağıt kilitlenince gri dönüşüm ve köşe arama sadece kağıdın çevresinde
+    core::SearchWindow searchWindow;
+    searchWindow.setEnabled(searchWindowOn);
+
+    // Otomatik yakalama: yakalanan kağıdın sonucu, kağıt kaldırılana kadar gösterilir
+    core::AutoCapture autoCapture;
+    autoCapture.setEnabled(autoMode);
+    AnswerKey::ScoreResult capturedScore;
+    std::map<std::string, std::string> capturedAnswers;
+
+    // Sonuç ekranları saklanan katmanlardır (her karede yeniden çizilmez)
+    core::OverlayLayer pausedLayer, capturedLayer;
+    std::map<std::string, std::string> pausedLayerAnswers;
+    int flashFrames = 0;
 
     bool isPaused = false;
     bool recomputeScore = false;
 
-    cv::Mat currentFrame;
+    // Kareler havuzdan kiralanan tamponlara yakalanır; döngü kopya yerine bu tamponları paylaşır
+    core::FramePool framePool(4);
+    core::FramePool::Lease pausedLease;  // Duraklatılan kare (kira tutulur, kopyasız)
+    cv::Mat displayCanvas;    // Ekran tamponu: overlay'ler yakalama tamponuna çizilmez
+    cv::Mat pausedDisplay;    // Duraklatılmış ekran önbelleği
+    bool pausedDirty = false; // Ekran yeniden üretilmeli mi (tuş / yeni kare)
 
     AnswerKey::ScoreResult lastScore;
     std::map<std::string, std::string> lastStudentAnswers;
-    cv::Mat omrDebugImage;
-    cv::Mat bubbleDebugImage;
 
     cout << "=== OPTIK FORM OKUYUCU ===\n";
     cout << "P: durdur/sonuc\n";
     cout << "D: perspective debug ac/kapat\n";
     cout << "B: bubble debug ac/kapat\n";
     cout << "C: compare overlay ac/kapat\n";
-    cout << "R: rotate\n";
+    cout << "R: yon (oto / elle 0-90-180-270)\n";
+    cout << "G: kalite kapisi ac/kapat\n";
+    cout << "A: otomatik yakalama ac/kapat\n";
     cout << "+/-: threshold\n";
     cout << "ESC: cikis\n\n";
 
 
     // --- PENCERE AYARLARI
-    cv::namedWindow("Kamera", cv::WINDOW_NORMAL);
-    cv::namedWindow("Form Analizi", cv::WINDOW_NORMAL);
-    cv::namedWindow("Bubble Debug", cv::WINDOW_NORMAL);
-
-    cv::resizeWindow("Kamera", 960, 540);       // 1080p'nin yarısı
-    cv::resizeWindow("Form Analizi", 480, 640); // Dikey form için uygun oran
-    cv::resizeWindow("Bubble Debug", 480, 640); // Dikey form için uygun oran
+    if (!headless) {
+        cv::namedWindow("Kamera", cv::WINDOW_NORMAL);
+        cv::namedWindow("Form Analizi", cv::WINDOW_NORMAL);
+        cv::namedWindow("Bubble Debug", cv::WINDOW_NORMAL);
+
+        cv::resizeWindow("Kamera", 960, 540);       // 1080p'nin yarısı
+        cv::resizeWindow("Form Analizi", 480, 640); // Dikey form için uygun oran
+        cv::resizeWindow("Bubble Debug", 480, 640); // Dikey form için uygun oran
+    }
 
     while (true) {
         cv::Mat frame;
+        core::FramePool::Lease lease;   // Bu turun kare tamponu; tur sonunda havuza döner
 
-        // 1) Capture
-        if (!isPaused) {
-            if (!cap.read(frame) || frame.empty()) break;
-            currentFrame = frame.clone();
+        // 1) Capture: havuzdan kiralanan tampona (aynı boyutta yeniden ayırma / kopya yok)
+        if (!isPaused || !pausedLease.held()) {
+            if (maxFrames >= 0 && static_cast<long>(loopStats.latencyMs.size()) >= maxFrames) break;
+            lease = framePool.acquire();
+            if (!source->read(lease.mat()) || lease.mat().empty()) break;
+            frame = lease.mat();
+
+            // Duraklatma: P'den sonraki ilk kare sabitlenir (kira bırakılana kadar tutulur)
+            if (isPaused) {
+                pausedLease = std::move(lease);
+                pausedDirty = true;
+            }
         } else {
-            if (currentFrame.empty()) continue;
-            frame = currentFrame.clone();
+            frame = pausedLease.mat();
         }
 
-        // 2) Rotation
-        cv::Mat processedFrame = frame.clone();
-        if (rotationMode == 1) cv::rotate(frame, processedFrame, cv::ROTATE_90_CLOCKWISE);
-        else if (rotationMode == 2) cv::rotate(frame, processedFrame, cv::ROTATE_90_COUNTERCLOCKWISE);
-        else if (rotationMode == 3) cv::rotate(frame, processedFrame, cv::ROTATE_180);
-
-        // 3) Perspective + ROI
-        auto R = pc.findAndWarp(processedFrame, showDebug);
+        // Gecikme: kare alındıktan sonra işleme + overlay süresi
+        auto frameStart = std::chrono::steady_clock::now();
 
+        // Duraklatılmış ekran değişmediyse önbellekten gösterilir (okuma / çizim yok)
+        const bool reusePaused = isPaused && !pausedDirty && !pausedDisplay.empty();
         cv::Mat displayFrame;
-        if (showDebug && !R.debug.empty()) displayFrame = R.debug.clone();
-        else displayFrame = processedFrame.clone();
+        if (reusePaused) displayFrame = pausedDisplay;
+        else {
+            // 2) Yön: kare döndürülmez; dönüklük köşe sırasına katlanır (CornerFinder)
+
+            // Arama penceresi: kilitliyken son kağıt konumu + pay (kopyasız görünüm),
+            // değilse / periyodik taramada tüm kare. Duraklatılmış kare her zaman tam taranır.
+            const cv::Rect searchRect = isPaused ? cv::Rect(0, 0, frame.cols, frame.rows)
+                                                 : searchWindow.next(frame.size());
+
+            // 3) Kalite kapısı: bulanık / hareketli karelerde warp ve okuma yapılmaz.
+            // Duraklatılmış karede kapı atlanır (operatör bu kareyi seçti).
+            bool gateOn = useQualityGate && !isPaused;
+            core::QualityVerdict quality;
+            // Kapı her zaman tam kareden sabit boyutlu (320 px) örnek alır: hareket ölçümü
+            // aynı alanı karşılaştırmalı, pencere yer / boyut değiştirse de
+            if (gateOn) quality = qualityGate.checkFrame(frame);
+
+            // 4) Perspective + ROI
+            core::WarpResult R;
+            bool searched = false;   // Köşe arama bu karede çalıştı mı (kapı geçirdiyse)
+            if (quality.decode) {
+                searched = true;
+                R = pc.findAndWarp(frame, showDebug, searchRect);
+                if (!isPaused) searchWindow.update(R.ok, R.corners);
+                if (gateOn) {
+                    if (R.ok) quality = qualityGate.checkCorners(R.corners);
+                    else qualityGate.resetCorners();
+                }
+            }
 
-        if (R.ok && !R.warped.empty()) {
-            detector.setDebugMode(showBubbleDebug);
+            // Kağıt kayboldu veya yer değiştirdi: birikmiş kararlar yeni kağıda taşınmaz.
+            // Bulanık diye atlanan karede hiçbir şey ölçülmedi; füzyon korunur (odak arayışı)
+            if (!isPaused && ((searched && !R.ok) ||
+                quality.reason == core::QualityVerdict::Reason::Moving ||
+                quality.reason == core::QualityVerdict::Reason::CornersUnstable)) {
+                detector.resetTemporalState();
+            }
 
-            // Canlı okuma (tc_kimlik / ogrenci_no / adi_soyadi dahil)
-            lastStudentAnswers = detector.process(R.warped, omrDebugImage);
+            // Overlay hedefi: debug görüntüsü zaten ayrı tampondur. Sabitlenen kare temiz
+            // kalmalıdır, gri kaynak (V4L2 / ham kayıt) pencerede renkli gösterilir: bu iki
+            // durumda ekran tamponuna kopyalanır. Canlı renkli kare kiralık yakalama tamponudur
+            // (kira imshow'dan sonra, tur sonunda bırakılır); ilk overlay çiziminde ekran
+            // tamponuna kopyalanır ki yakalama tamponu temiz kalsın. Başsız çalışmada overlay
+            // çizilmez: kare hiç kopyalanmaz / dönüştürülmez.
+            const bool drawOverlay = !headless;
+            if (showDebug && !R.debug.empty()) displayFrame = R.debug;
+            else if (isPaused || (frame.channels() == 1 && !headless)) {
+                if (frame.channels() == 1) cv::cvtColor(frame, displayCanvas, cv::COLOR_GRAY2BGR);
+                else frame.copyTo(displayCanvas);
+                displayFrame = displayCanvas;
+            }
+            else displayFrame = frame;
 
-            bubbleDebugImage = detector.getLastDebugVisualization();
-            if (showBubbleDebug && !bubbleDebugImage.empty()) cv::imshow("Bubble Debug", bubbleDebugImage);
-            if (!omrDebugImage.empty()) cv::imshow("Form Analizi", omrDebugImage);
+            auto drawTarget = [&]() -> cv::Mat& {
+                if (displayFrame.data == frame.data) {
+                    frame.copyTo(displayCanvas);
+                    displayFrame = displayCanvas;
+                }
+                return displayFrame;
+            };
+
+            if (R.ok && !R.warped.empty() && quality.decode) {
+                // İz sadece görünür debug pencereleri için tutulur; hiçbiri yoksa okuma
+                // döngülerinin iz kodu olmayan örneği çalışır
+                cv::Size formView, bubbleView;
+                const bool formVisible = !headless && visibleWindowSize("Form Analizi", formView);
+                const bool bubbleVisible = !headless && showBubbleDebug && visibleWindowSize("Bubble Debug", bubbleView);
+                detector.setDebugMode(formVisible || bubbleVisible);
+
+                // Canlı okuma (tc_kimlik / ogrenci_no / adi_soyadi dahil)
+                lastStudentAnswers = detector.process(R.warped);
+
+                // Görseller izden, pencere çözünürlüğünde üretilir
+                if (formVisible)
+                    cv::imshow("Form Analizi", core::renderDecodeTrace(R.warped, detector.lastTrace(), formView, false));
+                if (bubbleVisible)
+                    cv::imshow("Bubble Debug", core::renderDecodeTrace(R.warped, detector.lastTrace(), bubbleView, true));
+
+                // Pause anında 1 kez skor
+                if (isPaused && recomputeScore) {
+                    lastScore = answerKey.calculateScore(lastStudentAnswers);
+                    recomputeScore = false;
+                    pausedLayer.invalidate();
+                }
 
-            // Pause anında 1 kez skor
-            if (isPaused && recomputeScore) {
-                lastScore = answerKey.calculateScore(lastStudentAnswers);
-                recomputeScore = false;
+                if (drawOverlay && isPaused) {
+                    // Katman sadece okunan cevaplar değişirse yeniden çizilir
+                    if (!pausedLayer.valid(displayFrame.size()) || pausedLayerAnswers != lastStudentAnswers) {
+                        buildResultLayer(pausedLayer, displayFrame.size(), lastScore, lastStudentAnswers,
+                                         answerKeyMap, showCompareOverlay,
+                                         "SONUC EKRANI (Canli icin P)", cv::Scalar(0, 0, 255), 6);
+                        pausedLayerAnswers = lastStudentAnswers;
+                    }
+                    pausedLayer.composite(drawTarget());
+                } else if (drawOverlay && !autoCapture.isEnabled()) {
+                    cv::putText(drawTarget(), "Hizala ve 'P' tusuna bas", cv::Point(40, 40),
+                                cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 0), 2);
+                } else if (drawOverlay && autoCapture.state() == core::AutoCapture::State::Armed) {
+                    cv::putText(drawTarget(), "Otomatik: kagidi sabit tutun", cv::Point(40, 40),
+                                cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 0), 2);
+                }
+
+            } else {
+                if (isPaused && drawOverlay) {
+                    cv::putText(drawTarget(), "KAGIT BULUNAMADI!", cv::Point(50, 200),
+                                cv::FONT_HERSHEY_SIMPLEX, 1.5, cv::Scalar(0, 0, 255), 3);
+                }
             }
 
-            if (isPaused) {
-                // 1) Score overlay
-                if (lastScore.totalQuestions > 0) drawScoreOverlay(displayFrame, lastScore);
+            // 4b) Otomatik yakalama: köşeler sabit ve tüm bölgeler oturduysa notlandır
+            if (!isPaused && autoCapture.isEnabled()) {
+                // Kapının attığı karede köşe aranmadı: kağıt "yok" sayılmaz (yinelenen yakalama olur)
+                const auto presence = !searched ? core::AutoCapture::Presence::Unknown
+                                    : R.ok      ? core::AutoCapture::Presence::Present
+                                                : core::AutoCapture::Presence::Absent;
+                bool ready = R.ok && quality.decode && detector.allRegionsSettled();
+                std::string idKey = ready ? core::makeIdentityKey(lastStudentAnswers) : std::string();
+
+                auto ev = autoCapture.update(presence, ready, idKey);
+                if (ev == core::AutoCapture::Event::Capture) {
+                    capturedAnswers = lastStudentAnswers;
+                    capturedScore = answerKey.calculateScore(capturedAnswers);
+
+                    core::BatchItem item;
+                    item.path = source->describe() + " @" + std::to_string(static_cast<long>(source->timestampMs())) + "ms";
+                    item.status = core::BatchItem::Status::Ok;
+                    item.outcome.ok = true;
+                    item.outcome.answers = capturedAnswers;
+                    item.outcome.score = capturedScore;
+                    std::cout << core::toJsonLine(item) << std::endl;
+
+                    std::cerr << '\a' << "Kagit #" << autoCapture.captureCount() << " kaydedildi\n";
+                    flashFrames = 8;
+                    capturedLayer.invalidate();
+                }
 
-                // 2) Kimlik bilgileri (büyük siyah)
-                drawIdentityOverlay(displayFrame, lastStudentAnswers, {40, 70});
+                if (drawOverlay && autoCapture.state() == core::AutoCapture::State::Holding) {
+                    if (!capturedLayer.valid(displayFrame.size())) {
+                        buildResultLayer(capturedLayer, displayFrame.size(), capturedScore, capturedAnswers,
+                                         answerKeyMap, showCompareOverlay,
+                                         "KAYDEDILDI - kagidi kaldirin", cv::Scalar(0, 200, 0), 0);
+                    }
+                    capturedLayer.composite(drawTarget());
+                }
 
-                // 3) Student vs Correct overlay (aşağıdan başlasın)
-                if (showCompareOverlay) {
-                    drawComparisonOverlay(displayFrame, lastStudentAnswers, answerKeyMap, {40, 220}, 70);
+                // Görsel işaret: yakalamadan sonraki birkaç karede kalın yeşil çerçeve
+                if (flashFrames > 0) {
+                    --flashFrames;
+                    if (drawOverlay)
+                        cv::rectangle(drawTarget(), cv::Point(0, 0),
+                                      cv::Point(displayFrame.cols, displayFrame.rows),
+                                      cv::Scalar(0, 255, 0), 24);
                 }
+            }
 
-                cv::rectangle(displayFrame, cv::Point(0, 0),
-                              cv::Point(displayFrame.cols, displayFrame.rows),
-                              cv::Scalar(0, 0, 255), 6);
-                cv::putText(displayFrame, "SONUC EKRANI (Canli icin P)", cv::Point(40, 40),
-                            cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 0, 255), 2);
-            } else {
-                cv::putText(displayFrame, "Hizala ve 'P' tusuna bas", cv::Point(40, 40),
-                            cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 0), 2);
+            // 5) Footer info (sadece ekran varken)
+            if (drawOverlay) {
+                string infoText;
+                if (rotationMode < 0) infoText = "Yon: OTO";
+                else infoText = "Yon: ELLE";
+                if (R.ok) infoText += " (" + std::to_string(R.quarterTurns * 90) + ")";
+
+                std::stringstream ts;
+                ts << fixed << setprecision(2) << detector.getFillThreshold();
+                infoText += " | Hassasiyet: " + ts.str();
+
+                if (gateOn) {
+                    std::stringstream qs;
+                    qs << fixed << setprecision(0) << " | Kalite: " << quality.text()
+                       << " (keskinlik " << quality.sharpness
+                       << ", hareket " << setprecision(1) << quality.motion << ")";
+                    infoText += qs.str();
+                } else if (!useQualityGate) {
+                    infoText += " | Kalite: KAPALI";
+                }
+
+                if (searchRect.size() != frame.size())
+                    infoText += " | Pencere: " + std::to_string(searchRect.width) + "x" + std::to_string(searchRect.height);
+
+                infoText += std::string(" | Oto: ") + autoCapture.stateText();
+                if (autoCapture.isEnabled()) infoText += " (" + std::to_string(autoCapture.captureCount()) + ")";
+
+                cv::putText(drawTarget(), infoText, cv::Point(40, displayFrame.rows - 50),
+                            cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 255, 0), 2);
             }
 
-        } else {
             if (isPaused) {
-                cv::putText(displayFrame, "KAGIT BULUNAMADI!", cv::Point(50, 200),
-                            cv::FONT_HERSHEY_SIMPLEX, 1.5, cv::Scalar(0, 0, 255), 3);
+                pausedDisplay = displayFrame;
+                pausedDirty = false;
             }
         }
 
-        // 4) Footer info
-        string infoText;
-        if (rotationMode == 0) infoText = "Rot: OFF";
-        else if (rotationMode == 1) infoText = "Rot: 90 CW";
-        else if (rotationMode == 2) infoText = "Rot: 90 CCW";
-        else if (rotationMode == 3) infoText = "Rot: 180";
-
-        std::stringstream ts;
-        ts << fixed << setprecision(2) << detector.getFillThreshold();
-        infoText += " | Hassasiyet: " + ts.str();
+        if (!isPaused) loopStats.add(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - frameStart).count());
 
-        cv::putText(displayFrame, infoText, cv::Point(40, displayFrame.rows - 50),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 255, 0), 2);
+        if (headless) continue;
 
         cv::imshow("Kamera", displayFrame);
 
-        // 5) Keys
+        // 6) Keys
         int k = cv::waitKey(1) & 0xFF;
         if (k == 27) break;
 
+        // Duraklatılmışken herhangi bir tuş ekranı değiştirebilir
+        if (k != 255) pausedDirty = true;
+
         if (k == 'p' || k == 'P') {
             isPaused = !isPaused;
             if (isPaused) recomputeScore = true;
+            pausedLease.release();
+            pausedDisplay.release();
         }
 
         if (k == 'd' || k == 'D') showDebug = !showDebug;
 
-        if (k == 'r' || k == 'R') rotationMode = (rotationMode + 1) % 4;
+        if (k == 'r' || k == 'R') {
+            rotationMode = (rotationMode == 3) ? -1 : rotationMode + 1;  // OTO -> 0 -> 90 -> 180 -> 270 -> OTO
+            pc.setOrientationOverride(rotationMode);
+            detector.resetTemporalState();
+        }
+
+        if (k == 'g' || k == 'G') {
+            useQualityGate = !useQualityGate;
+            qualityGate.resetCorners();
+        }
+
+        if (k == 'a' || k == 'A') autoCapture.setEnabled(!autoCapture.isEnabled());
 
         if (k == '+' || k == '=') detector.setFillThreshold(detector.getFillThreshold() + 0.05);
         if (k == '-' || k == '_') detector.setFillThreshold(max(0.05, detector.getFillThreshold() - 0.05));
@@ -443,14 +916,30 @@ int main(int argc, char** argv) {
         if (k == 'b' || k == 'B') {
             showBubbleDebug = !showBubbleDebug;
             if (!showBubbleDebug) { try { cv::destroyWindow("Bubble Debug"); } catch (...) {} }
+            else {
+                cv::namedWindow("Bubble Debug", cv::WINDOW_NORMAL);
+                cv::resizeWindow("Bubble Debug", 480, 640);
+            }
         }
 
         if (k == 'c' || k == 'C') {
             showCompareOverlay = !showCompareOverlay;
+            pausedLayer.invalidate();
+            capturedLayer.invalidate();
         }
     }
 
-    cap.release();
-    cv::destroyAllWindows();
+    loopStats.print(std::cerr);
+    std::cerr << "Kare havuzu: " << framePool.size() << " tampon, "
+              << framePool.allocations() << " ayirma\n";
+
+    const auto& cs = detector.cascadeStats();
+    if (cs.rows > 0) {
+        std::cerr << "Kaskad: " << cs.refined << "/" << cs.rows << " satir tam cozunurlukte tekrar olculdu ("
+                  << std::fixed << std::setprecision(1) << (100.0 * cs.refined / cs.rows) << "%)\n";
+    }
+
+    source.reset();
+    if (!headless) cv::destroyAllWindows();
     return 0;
 }
@@ -0,0 +1,201 @@
+// Python bağlaması (pybind11): arşiv taramalarını notebook'larda süreç başlatmadan işlemek için.
+//
+//  - NumPy dizileri kopyalanmadan cv::Mat başlığıyla sarılır (satır içi bitişik olmalı)
+//  - Ağır işlemler GIL bırakılarak çalışır; thread havuzları ölçeklenir.
+//    Her nesne thread-safe DEĞİLDİR: thread başına ayrı PerspectiveCorrector / ROIDetector.
+//  - Çıktı görüntüleri ve hücre skorları, cv::Mat tamponunu paylaşan NumPy görünümleridir
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnswerKey.hpp"
+#include "ROIDetector.hpp"
+#include "core/PerspectiveCorrector.hpp"
+#include "core/TemplateConfig.hpp"
+#include "core/WarpProfile.hpp"
+
+namespace py = pybind11;
+
+namespace {
+
+// uint8 HxW veya HxWxC dizisini kopyasız Mat'e sarar. Dizi çağrı süresince Python
+// tarafında referanslı kaldığından GIL bırakılsa da tampon geçerlidir.
+cv::Mat matView(const py::array& arr) {
+    if (!py::isinstance<py::array_t<uint8_t>>(arr))
+        throw py::type_error("uint8 goruntu bekleniyor");
+
+    const py::buffer_info b = arr.request();
+    if (b.ndim != 2 && b.ndim != 3) throw py::value_error("HxW veya HxWxC goruntu bekleniyor");
+
+    const int rows = static_cast<int>(b.shape[0]);
+    const int cols = static_cast<int>(b.shape[1]);
+    const int cn = b.ndim == 3 ? static_cast<int>(b.shape[2]) : 1;
+    if (cn != 1 && cn != 3) throw py::value_error("1 veya 3 kanal bekleniyor");
+
+    // Satır içi bitişik olmalı; satır adımı serbest (dilimlenmiş ROI'ler de kopyasız)
+    const bool rowContiguous = b.strides[1] == cn && (b.ndim == 2 || b.strides[2] == 1);
+    if (!rowContiguous || b.strides[0] < 0)
+        throw py::value_error("satir ici bitisik dizi bekleniyor (np.ascontiguousarray)");
+
+    return cv::Mat(rows, cols, CV_8UC(cn), b.ptr, static_cast<size_t>(b.strides[0]));
+}
+
+// Mat'i kopyalamadan NumPy dizisine çevirir; Mat referansı capsule'da yaşar
+py::array toNumpy(const cv::Mat& m) {
+    if (m.empty()) return py::array();
+
+    auto* keep = new cv::Mat(m);
+    py::capsule owner(keep, [](void* p) { delete static_cast<cv::Mat*>(p); });
+
+    const py::ssize_t es = static_cast<py::ssize_t>(m.elemSize1());
+    const py::ssize_t cn = m.channels();
+    std::vector<py::ssize_t> shape = {m.rows, m.cols};
+    std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(m.step[0]), es * cn};
+    if (cn > 1) {
+        shape.push_back(cn);
+        strides.push_back(es);
+    }
+
+    switch (m.depth()) {
+        case CV_8U:  return py::array(py::dtype::of<uint8_t>(), shape, strides, keep->data, owner);
+        case CV_32F: return py::array(py::dtype::of<float>(), shape, strides, keep->data, owner);
+        case CV_64F: return py::array(py::dtype::of<double>(), shape, strides, keep->data, owner);
+        default: throw py::type_error("desteklenmeyen Mat tipi");
+    }
+}
+
+core::SpeedPreset presetFromString(const std::string& s) {
+    core::SpeedPreset p;
+    if (!core::parseSpeedPreset(s, p)) throw py::value_error("preset: fast|balanced|accurate");
+    return p;
+}
+
+ROIDetector::ScoringMode scoringFromString(const std::string& s) {
+    if (s == "threshold") return ROIDetector::SCORE_THRESHOLD;
+    if (s == "darkness") return ROIDetector::SCORE_DARKNESS;
+    throw py::value_error("scoring: threshold|darkness");
+}
+
+py::dict scoreToDict(const AnswerKey::ScoreResult& sc) {
+    py::dict d;
+    d["total"] = sc.totalScore;
+    d["questions"] = sc.totalQuestions;
+    d["correct"] = sc.totalCorrect;
+    d["wrong"] = sc.totalWrong;
+    d["empty"] = sc.totalEmpty;
+
+    py::dict subjects;
+    for (const auto& kv : sc.subjectDetails) {
+        py::dict s;
+        s["correct"] = kv.second.correct;
+        s["wrong"] = kv.second.wrong;
+        s["empty"] = kv.second.empty;
+        s["net"] = kv.second.net;
+        subjects[py::str(kv.first)] = s;
+    }
+    d["subjects"] = subjects;
+    return d;
+}
+
+}
+
+PYBIND11_MODULE(omr, m) {
+    m.doc() = "Optik form okuma cekirdegi";
+
+    m.def("warp_profile", [](const std::string& preset, const std::string& templateJson) {
+        ROIDetector probe;
+        if (!templateJson.empty()) {
+            core::FormTemplate t;
+            std::string err;
+            if (!core::parseTemplateJson(templateJson, t, err)) throw py::value_error(err);
+            probe.setTemplate(t.regions, t.subjects);
+        }
+        auto p = core::makeWarpProfile(probe.minCellPitch(), presetFromString(preset));
+        py::dict d;
+        d["width"] = p.width;
+        d["height"] = p.height;
+        d["scale"] = p.scale;
+        d["bubble_px"] = p.bubblePx;
+        return d;
+    }, py::arg("preset") = "balanced", py::arg("template_json") = "",
+       "Sablondan warp boyutu ve cekirdek olcegi");
+
+    py::class_<core::PerspectiveCorrector>(m, "PerspectiveCorrector")
+        .def(py::init([](int w, int h, double kernelScale) {
+            auto pc = std::make_unique<core::PerspectiveCorrector>(w, h);
+            pc->setKernelScale(kernelScale);
+            return pc;
+        }), py::arg("width") = core::kReferenceWarpW, py::arg("height") = core::kReferenceWarpH,
+            py::arg("kernel_scale") = 1.0)
+        .def("set_orientation_override", &core::PerspectiveCorrector::setOrientationOverride)
+        .def("set_layout_signature", [](core::PerspectiveCorrector& self, const ROIDetector& det) {
+            self.setLayoutSignature(det.layoutSignature());
+        }, "Yon tespiti icin sablon imzasini detektorden alir")
+        .def("find_and_warp", [](const core::PerspectiveCorrector& self, const py::array& image) {
+            const cv::Mat img = matView(image);
+            core::WarpResult R;
+            {
+                py::gil_scoped_release nogil;
+                R = self.findAndWarp(img, false);
+            }
+            py::list corners;
+            if (R.ok) for (const auto& p : R.corners) corners.append(py::make_tuple(p.x, p.y));
+            return py::make_tuple(R.ok, R.ok ? toNumpy(R.warped) : py::array(), corners, R.quarterTurns);
+        }, py::arg("image"),
+           "(ok, warped, corners, quarter_turns); warped BGR uint8 gorunum");
+
+    py::class_<ROIDetector>(m, "ROIDetector")
+        .def(py::init([](const std::string& templateJson) {
+            auto det = std::make_unique<ROIDetector>();
+            if (!templateJson.empty()) {
+                core::FormTemplate t;
+                std::string err;
+                if (!core::parseTemplateJson(templateJson, t, err)) throw py::value_error(err);
+                det->setTemplate(t.regions, t.subjects);
+            }
+            det->setDebugMode(false);
+            det->setCellScoreCapture(true);
+            return det;
+        }), py::arg("template_json") = "")
+        .def("set_fill_threshold", &ROIDetector::setFillThreshold)
+        .def("set_warp_scale", &ROIDetector::setWarpScale)
+        .def("set_cascade", &ROIDetector::setCascade)
+        .def("set_scoring_mode", [](ROIDetector& self, const std::string& s) {
+            self.setScoringMode(scoringFromString(s));
+        })
+        .def("process", [](ROIDetector& self, const py::array& warped) {
+            const cv::Mat img = matView(warped);
+            std::map<std::string, std::string> out;
+            {
+                py::gil_scoped_release nogil;
+                out = self.process(img);
+            }
+            return out;
+        }, py::arg("warped"), "Alan adi -> okunan deger")
+        .def("cell_scores", [](const ROIDetector& self) {
+            py::dict d;
+            for (const auto& kv : self.cellScores()) d[py::str(kv.first)] = toNumpy(kv.second);
+            return d;
+        }, "Son process() cagrisindaki ders gridlerinin hucre skorlari (rows x cols float64)");
+
+    py::class_<AnswerKey>(m, "AnswerKey")
+        .def(py::init([](const std::map<std::string, std::string>& key) {
+            std::vector<AnswerKey::QuestionAnswer> qa;
+            for (const auto& kv : key)
+                for (int i = 0; i < static_cast<int>(kv.second.size()); ++i)
+                    qa.push_back({kv.first, i, kv.second[i]});
+            auto k = std::make_unique<AnswerKey>();
+            k->loadAnswerKey(qa);
+            return k;
+        }), py::arg("key"), "Ders adi -> cevap dizisi (ornek: {'turkce': 'CBAAB...'})")
+        .def("score", [](AnswerKey& self, const std::map<std::string, std::string>& answers) {
+            return scoreToDict(self.calculateScore(answers));
+        }, py::arg("answers"));
+}